@@ -0,0 +1,101 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Forwards, we only deal with pointers/refs here
+struct Shape;
+struct RigidBody2D;
+using SoftBody2D = Shape;
+
+// A pair of rigid body indices (first < second)
+using BodyPair = std::pair<uint32_t, uint32_t>;
+
+// Axis aligned bounds, not to be confused with the AABB shape
+struct Bounds
+{
+	glm::vec2 v2Min;
+	glm::vec2 v2Max;
+
+	bool IsOverlapping( const Bounds& other ) const;
+	void Merge( const Bounds& other );
+};
+
+// Tight bounds around a shape's current position
+Bounds GetBounds( const Shape * pShape );
+
+// Bounds covering a rigid body now and after it moves for fDT
+Bounds GetSweptBounds( const RigidBody2D * pRB, float fDT );
+
+// Sort and sweep along the x axis. The sorted order is kept
+// between frames, so since things don't move much per step
+// an insertion sort gets it back in order for close to free
+class SortAndSweep
+{
+public:
+	SortAndSweep();
+
+	// Recompute swept bounds, re-sort, and find overlapping pairs
+	void Update( const std::vector<RigidBody2D>& vBodies, float fDT );
+
+	const std::vector<BodyPair>& GetPairs() const;
+	uint32_t GetNumSwaps() const;
+
+private:
+	std::vector<uint32_t> m_vOrder;		// Body indices sorted by min x
+	std::vector<Bounds> m_vBounds;		// Swept bounds, indexed by body
+	std::vector<BodyPair> m_vPairs;		// Candidate pairs from the last update
+	uint32_t m_uNumSwaps;				// Insertion sort swaps in the last update
+};
+
+// Uniform grid spatial hash. Bodies are binned into every cell
+// their bounds touch, and pairs sharing a cell become candidates.
+// This doesn't care how things pile up along an axis, which is
+// what hurts sort and sweep when everything lands on the floor.
+// Bodies that would touch too many cells aren't binned, they're
+// checked against everything else instead
+class SpatialHashGrid
+{
+public:
+	SpatialHashGrid();
+
+	// Rebin everything and find overlapping pairs. Rigid bodies use
+	// swept bounds, soft bodies use their current bounds
+	void Update( const std::vector<RigidBody2D>& vBodies, const std::vector<SoftBody2D>& vSoftBodies, float fDT );
+
+	// Rigid body pairs, indices into vBodies
+	const std::vector<BodyPair>& GetPairs() const;
+
+	// Soft/rigid pairs, (soft body index, rigid body index)
+	const std::vector<BodyPair>& GetSoftPairs() const;
+
+	float GetCellSize() const;
+
+private:
+	// A proxy binned into one cell
+	struct Entry
+	{
+		int32_t iX, iY;		// Cell coords
+		uint32_t uProxy;	// Rigid bodies first, then soft bodies
+	};
+
+	uint32_t bucketIdx( int32_t iX, int32_t iY ) const;
+	bool canPair( uint32_t uA, uint32_t uB ) const;
+	void addPair( uint32_t uA, uint32_t uB, int32_t iX, int32_t iY );
+	void reportPair( uint32_t uA, uint32_t uB );
+
+	float m_fCellSize;						// Derived from the median extent
+	uint32_t m_uNumRigid;					// Proxies below this are rigid
+	std::vector<Bounds> m_vBounds;			// Indexed by proxy
+	std::vector<bool> m_vActive;			// Indexed by proxy
+	std::vector<float> m_vExtents;			// Scratch for the median
+	std::vector<Entry> m_vEntries;			// Entries in insertion order
+	std::vector<Entry> m_vSorted;			// Entries sorted by bucket
+	std::vector<uint32_t> m_vBucketStart;	// Offsets into m_vSorted
+	std::vector<uint32_t> m_vOversized;		// Proxies too big to bin
+	std::vector<BodyPair> m_vPairs;
+	std::vector<BodyPair> m_vSoftPairs;
+};
@@ -30,7 +30,7 @@ public:
 	quatvec GetTransform() const;
 	mat4 GetProjMat() const;
 	mat4 GetTransformMat() const;
-	mat4 GetCameraMat() const;
+	mat4 GetCameraMat() const;	// Cached, rebuilt after a change
 
 	void Translate( vec3 t );
 	void Translate( vec2 t );
@@ -45,6 +45,8 @@ private:
 	int m_nScreenHeight;
 	quatvec m_qvTransform;
 	mat4 m_m4Proj;
+	mutable bool m_bCamMatDirty;
+	mutable mat4 m_m4CameraMat;
 
 	static GLint s_CamMatHandle;
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// A change (or lack of one) in a pair's collision state between two
+// steps. The keys are the pair's, smallest first
+struct CollisionEvent
+{
+	enum class EType : int
+	{
+		Begin,		// Colliding now, wasn't last step
+		Persist,	// Colliding now and last step
+		End			// Was colliding last step, isn't now
+	};
+
+	EType eType;
+	uint32_t uKeyA;
+	uint32_t uKeyB;
+};
+
+// Whether each pair of bodies that got checked this step was colliding.
+// Bodies are identified by a key (the Scene uses their handles), and
+// the order within a pair doesn't matter. It's a flat open addressing
+// table, and Clear just bumps a generation counter: slots stamped with
+// an older generation count as empty, so there's nothing to free
+class CollisionBank
+{
+public:
+	CollisionBank();
+
+	// Forget every pair
+	void Clear();
+
+	void Set( uint32_t uKeyA, uint32_t uKeyB, bool bColliding );
+
+	// False for pairs that weren't set since the last Clear
+	bool Get( uint32_t uKeyA, uint32_t uKeyB ) const;
+
+	size_t Size() const;
+
+	// Append the events that take prev to this bank. Pairs that were
+	// in neither state, or that aren't in a bank at all, aren't colliding
+	void Diff( const CollisionBank& prev, std::vector<CollisionEvent>& vEvents ) const;
+
+private:
+	struct Slot
+	{
+		uint64_t uPair;
+		uint32_t uGen;
+		bool bColliding;
+	};
+
+	static uint64_t makePair( uint32_t uKeyA, uint32_t uKeyB );
+	size_t findSlot( uint64_t uPair ) const;
+	void grow();
+
+	std::vector<Slot> m_vSlots;		// Size is a power of two
+	std::vector<uint32_t> m_vLive;	// Slots used this generation
+	uint32_t m_uGen;
+};
@@ -28,6 +28,11 @@ Contact GetSpecContact( AABB * pAABB, Plane * pPlane );
 Contact GetSpeculativeContact( const RigidBody2D * pA, const RigidBody2D * pB );
 Contact GetSpeculativeContact( const Plane * pPlane, const RigidBody2D * pB );
 
+// What GetSpeculativeContact calls for A and B's type pair, from an
+// [EType][EType] table. Pairs of the same types can look it up once
+using SpecContactFn = Contact( *)(const RigidBody2D *, const RigidBody2D *);
+SpecContactFn GetSpecContactFn( const Shape * pA, const Shape * pB );
+
 ////////////////////////////////////////////////////////////////////////////
 
 // Functions for detecting overlap
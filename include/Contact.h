@@ -7,9 +7,15 @@ struct Plane;
 // Forward for debugging
 class Drawable;
 
+// Forward for the island solver
+class JobPool;
+
+#include "Util.h"
+
 #include <glm/vec2.hpp>
-#include <list>
 #include <array>
+#include <vector>
+#include <cstdint>
 
 // Contact for speculative contact collision detection
 class Contact
@@ -32,7 +38,7 @@ public:
 
 	float GetDistance() const;
 	float GetAvgCoefRest() const;
-	float GetInvMass() const;
+	float GetEffectiveMass() const;
 	float GetCurImpulse() const;
 
 	bool HasPlane() const;
@@ -42,15 +48,43 @@ public:
 	const RigidBody2D * GetBodyA() const;
 	const RigidBody2D * GetBodyB() const;
 
+	// Identifies the pair between steps, see ContactCache
+	void SetCacheKey( uint64_t uKey );
+	uint64_t GetCacheKey() const;
+
 	// The Solver class, which really only does one thing...
 	class Solver
 	{
 	public:
 		Solver();
 		Solver( uint32_t nIterations );
-		uint32_t Solve( std::list<Contact>& liContacts );
+		uint32_t Solve( Span<Contact> spContacts );
+
+		// Solve islands independently across the pool. spOrder lists
+		// contact indices grouped by island, island i's run being
+		// [spIslandStart[i], spIslandStart[i+1])
+		uint32_t SolveIslands( Span<Contact> spContacts, Span<const uint32_t> spOrder, Span<const uint32_t> spIslandStart, JobPool& jobPool );
+
+		void SetIterations( uint32_t nIterations );
+		uint32_t GetIterations() const;
+
+		// The step contacts have to close their distance in
+		void SetTimeStep( float fDT );
+
+		// How many iterations the last Solve took to converge
+		// (for SolveIslands, the most any island took)
+		uint32_t GetLastIterations() const;
+
+		// Per island iteration counts from the last SolveIslands
+		const std::vector<uint32_t>& GetIslandIterations() const;
 	private:
+		bool solveContact( Contact& c ) const;
+
 		uint32_t m_nIterations;
+		float m_fInvTimeStep;
+		uint32_t m_nLastIterations;
+		std::vector<uint32_t> m_vIslandIterations;
+		std::vector<uint32_t> m_vIslandCollisions;
 	};
 
 	// Init a drawable, for debugging purposes
@@ -78,8 +112,9 @@ private:
 	bool m_bHasPlane;		// duh
 	bool m_bIsColliding;	// Whether or not the contact is colliding
 	float m_fDist;			// The distance between the contact pair
-	float m_fInvMass;		// 1 / the impulse mass
+	float m_fEffMass;		// 1 / the sum of inverse masses
 	float m_fCurImpulse;	// The accumulated impulse value
+	uint64_t m_uCacheKey;	// Bodies (or plane and body) that made us
 	glm::vec2 m_v2Normal;	// The collision normal (out of A)
 
 	void init();
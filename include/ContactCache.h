@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Contact.h"
+#include "Util.h"
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Remembers the accumulated impulse of every contact between steps,
+// keyed by which bodies (or plane and body) made it. Contacts that
+// show up again get that impulse back before solving (warm starting),
+// so resting stacks don't have to be rebuilt from zero every step
+class ContactCache
+{
+public:
+	ContactCache();
+
+	static uint64_t MakePairKey( uint32_t uBodyA, uint32_t uBodyB );
+	static uint64_t MakePlaneKey( uint32_t uPlane, uint32_t uBody );
+
+	// Reapply last step's impulses, scaled by fFactor. The impulse is
+	// capped so it never pushes a pair further apart than touching
+	void WarmStart( Span<Contact> spContacts, float fFactor, float fInvDT );
+
+	// Remember this step's impulses for the next one
+	void Store( Span<const Contact> spContacts );
+
+	uint32_t GetNumWarmStarted() const;
+
+private:
+	using Entry = std::pair<uint64_t, float>;
+	std::vector<Entry> m_vEntries;	// Sorted by key
+	uint32_t m_uNumWarmStarted;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "Util.h"
+
+#include <vector>
+
+// Batched narrowphase kernels. They read positions and sizes out of
+// the RigidBodyStore's arrays (which this step's integration pass
+// fills) and do several pairs per SSE / AVX instruction,
+// with a scalar loop for the leftovers or when there's no SIMD
+
+class Contact;
+class RigidBodyStore;
+struct RigidBody2D;
+struct Plane;
+
+// Same contacts GetSpecContact( Circle *, Circle * ) makes, writes
+// pOut[i] for spPairs[i]. pBodies is the scene's rigid body array
+void GetCircleContacts( const RigidBodyStore& store, RigidBody2D * pBodies, Span<const BodyPair> spPairs, Contact * pOut );
+
+// Same contacts GetSpecContact( AABB *, AABB * ) makes, bit for bit
+void GetBoxContacts( const RigidBodyStore& store, RigidBody2D * pBodies, Span<const BodyPair> spPairs, Contact * pOut );
+
+// Indices of the active, awake, movable bodies that could reach the plane
+// this step, i.e. whose distance to it (less what their velocity closes in
+// fDT) is within fMargin. Written to pOut in order, which needs room for
+// every body. Returns how many there were
+size_t GetPlaneCandidates( const RigidBodyStore& store, const Plane& plane, float fDT, float fMargin, uint32_t * pOut );
@@ -18,7 +18,8 @@ public:
 	glm::vec3 GetPos() const;
 	glm::fquat GetRot() const;
 	quatvec GetTransform() const;
-	glm::mat4 GetMV() const;
+	glm::mat4 GetMV() const;	// Cached, rebuilt after the transform changes
+	glm::mat4 GetMV( glm::vec2 v2Pos ) const;	// As if at v2Pos
 
 	void SetPos3D( glm::vec3 t );
 	void Translate3D( glm::vec3 t );
@@ -39,6 +40,8 @@ public:
 	void SetColor( glm::vec4 c );
 
 	bool Draw();
+	bool DrawInstanced( GLsizei nInstances ) const;	// Instance attribs must be set up
+	GLuint GetVAO() const;
 
 	static void SetPosHandle( GLint h );
 	static GLint GetPosHandle();
@@ -55,6 +58,8 @@ public:
 
 	using VAOData = std::array<GLuint, 2>;
 private:	
+	void updateMV() const;
+
 	bool m_bActive;
 	GLuint m_VAO;
 	GLuint m_nIdx;
@@ -62,6 +67,8 @@ private:
 	glm::vec4 m_v4Color;
 	quatvec m_qvTransform;
 	std::string m_strSrcFile;
+	mutable bool m_bMVDirty;
+	mutable glm::mat4 m_m4MV;
 
 	// Static VAO cache (string to VAO/nIdx)
 	static std::map<std::string, VAOData> s_VAOCache;
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Broadphase.h"
+
+#include <vector>
+#include <cstdint>
+
+// Dynamic bounding volume tree. Leaves hold fattened bounds, so
+// a proxy that moves a little doesn't have to be touched at all,
+// and the tree is kept balanced with AVL style rotations
+class DynamicTree
+{
+public:
+	DynamicTree( float fMargin = 0.2f );
+
+	// Returns a proxy id that stays valid until destroyed
+	int CreateProxy( const Bounds& bounds, uint32_t uData );
+	void DestroyProxy( int iProxy );
+
+	// Returns true if the proxy left its fat bounds and was reinserted
+	bool MoveProxy( int iProxy, const Bounds& bounds );
+
+	uint32_t GetData( int iProxy ) const;
+
+	// Calls fnCallback( uData ) for every leaf whose fat bounds overlap
+	template<typename F>
+	void Query( const Bounds& bounds, F fnCallback ) const;
+
+	// Stats for tuning
+	int GetHeight() const;
+	int GetNodeCount() const;
+	int GetProxyCount() const;
+
+private:
+	struct Node
+	{
+		Bounds bounds;		// Fat for leaves, union of children otherwise
+		int iParent;		// Doubles as the free list link
+		int iChild1;
+		int iChild2;		// -1 for leaves
+		int iHeight;		// 0 for leaves, -1 if free
+		uint32_t uData;		// Only meaningful for leaves
+
+		bool IsLeaf() const { return iChild1 < 0; }
+	};
+
+	int allocNode();
+	void freeNode( int iNode );
+	void insertLeaf( int iLeaf );
+	void removeLeaf( int iLeaf );
+	int balance( int iA );
+	void refitUp( int iNode );
+
+	float m_fMargin;
+	int m_iRoot;
+	int m_iFreeList;
+	int m_nNodes;
+	int m_nProxies;
+	std::vector<Node> m_vNodes;
+	mutable std::vector<int> m_vStack;	// Query scratch
+};
+
+template<typename F>
+void DynamicTree::Query( const Bounds& bounds, F fnCallback ) const
+{
+	if ( m_iRoot < 0 )
+		return;
+
+	m_vStack.clear();
+	m_vStack.push_back( m_iRoot );
+	while ( m_vStack.empty() == false )
+	{
+		int iNode = m_vStack.back();
+		m_vStack.pop_back();
+
+		const Node& n = m_vNodes[iNode];
+		if ( n.bounds.IsOverlapping( bounds ) == false )
+			continue;
+
+		if ( n.IsLeaf() )
+		{
+			fnCallback( n.uData );
+		}
+		else
+		{
+			m_vStack.push_back( n.iChild1 );
+			m_vStack.push_back( n.iChild2 );
+		}
+	}
+}
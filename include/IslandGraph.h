@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Util.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Union-find over body indices. Bodies that were linked
+// (through a contact, usually) end up in the same island,
+// and islands are handed out as contiguous runs of indices
+class IslandGraph
+{
+public:
+	IslandGraph();
+
+	// Start over with every body in its own island
+	void Reset( size_t nBodies );
+
+	// Put A and B in the same island
+	void Link( uint32_t uBodyA, uint32_t uBodyB );
+
+	// Flatten the sets into islands, call after linking
+	void Build();
+
+	size_t GetNumIslands() const;
+	uint32_t GetIsland( uint32_t uBody ) const;
+	Span<const uint32_t> GetIslandBodies( size_t uIsland ) const;
+
+private:
+	uint32_t find( uint32_t uBody );
+
+	std::vector<uint32_t> m_vParent;
+	std::vector<uint32_t> m_vSize;
+	std::vector<uint32_t> m_vIslandOf;		// Body -> island
+	std::vector<uint32_t> m_vIslandStart;	// Island -> first in m_vBodies
+	std::vector<uint32_t> m_vBodies;		// Bodies, grouped by island
+
+	// Build's scratch, kept so it doesn't allocate every step
+	std::vector<uint32_t> m_vRootIsland;	// Root -> island
+	std::vector<uint32_t> m_vCount;			// Island -> next slot in m_vBodies
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstdint>
+#include <cstddef>
+
+// A handful of worker threads that chew through numbered jobs.
+// The calling thread helps out, so a thread count of 1 means
+// everything runs inline and no workers are ever started
+class JobPool
+{
+public:
+	JobPool();
+	~JobPool();
+
+	JobPool( const JobPool& ) = delete;
+	JobPool& operator=( const JobPool& ) = delete;
+
+	// Total threads, including the caller (0 picks the hardware count)
+	void SetThreadCount( uint32_t nThreads );
+	uint32_t GetThreadCount() const;
+
+	// Calls fnJob( i ) for i in [0, nJobs), blocks until they're
+	// all done, then rethrows the first exception any of them threw
+	void Run( size_t nJobs, std::function<void( size_t )> fnJob );
+
+	// Splits [0, N) into one contiguous range per thread and calls
+	// fnRange( uChunk, uBegin, uEnd ). Chunk c always comes before
+	// chunk c+1, so merging per-chunk output in chunk order gives
+	// the same result as a serial loop, whatever the thread count
+	template<typename F>
+	void ParallelFor( size_t N, F fnRange );
+
+	// How many chunks ParallelFor will use for N items
+	size_t GetNumChunks( size_t N ) const;
+
+private:
+	void stopWorkers();
+	void workerLoop();
+	void drainJobs();
+
+	std::vector<std::thread> m_vWorkers;
+	std::mutex m_Mutex;
+	std::condition_variable m_cvWork;
+	std::condition_variable m_cvDone;
+	std::function<void( size_t )> m_fnJob;
+	std::exception_ptr m_pException;
+	size_t m_nJobs;
+	size_t m_nNextJob;
+	size_t m_nJobsLeft;
+	uint64_t m_uGeneration;	// Bumped for each Run, wakes the workers
+	bool m_bStop;
+};
+
+template<typename F>
+void JobPool::ParallelFor( size_t N, F fnRange )
+{
+	const size_t nChunks = GetNumChunks( N );
+	if ( nChunks <= 1 )
+	{
+		if ( N > 0 )
+			fnRange( 0, 0, N );
+		return;
+	}
+
+	Run( nChunks, [N, nChunks, &fnRange] ( size_t uChunk )
+	{
+		fnRange( uChunk, (N * uChunk) / nChunks, (N * (uChunk + 1)) / nChunks );
+	} );
+}
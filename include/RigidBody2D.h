@@ -22,7 +22,11 @@ struct Shape : public EntComponent
 		Triangle
 	};
 
+	// Size of the [EType][EType] dispatch tables
+	static const int kNumTypes = (int) EType::Triangle + 1;
+
 	bool bActive;		// If the shape is in the mix
+	bool bMoved;		// Set by SetCenterPos, cleared by the Scene
 	EType eType;		// Primitive type
 	glm::vec2 v2Center;	// Center position
 
@@ -55,16 +59,22 @@ struct RigidBody2D : public SoftBody2D
 {
 	RigidBody2D();
 
-	float fMass;		// Mass
+	float fMass;		// Mass (negative means immovable)
+	float fInvMass;		// 1 / mass, or 0 if immovable
 	float fElast;		// Elasticity
 	glm::vec2 v2Vel;	// Velocity
 	glm::vec2 v2Force;	// Acting force
 
+	bool bAsleep;			// Skipped by the Scene until woken
+	float fRestTime;		// How long we've been (nearly) still
+	glm::vec2 v2SleepForce;	// The force we were under when we fell asleep
+
 	// Various gets
 	glm::vec2 GetMomentum() const;
 	float GetKineticEnergy() const;
 
 	float GetMass() const;
+	float GetInvMass() const;
 
 	// Advance the object's position and velocity
 	// v2Force determines dV and is zeroed in this function
@@ -73,6 +83,9 @@ struct RigidBody2D : public SoftBody2D
 	void ApplyForce( glm::vec2 v2F );
 	void SetForce( glm::vec2 v2F );
 
+	bool GetIsAsleep() const;
+	void Wake();
+
 	RigidBody2D( glm::vec2 vel, glm::vec2 c, float mass, float elasticity);
 };
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct RigidBody2D;
+
+// Structure of arrays copy of the rigid body state the SIMD contact
+// kernels read. A body's handle is its index in the Scene's rigid body
+// vector, which is also what Python uses, so RigidBody2D stays the
+// public face (the solver writes to it too). The copy is made during
+// the integration pass, so keeping it costs no extra trip over the bodies
+class RigidBodyStore
+{
+public:
+	RigidBodyStore();
+
+	// Verlet advance every active, awake body in place (zeroing its
+	// force) and fill the arrays with the result, all in one pass
+	void Integrate( std::vector<RigidBody2D>& vBodies, float fDT );
+
+	// Same bodies and arrays afterward, but gathered into the arrays
+	// (forces too), advanced there with SSE / AVX, and scattered back.
+	// That's two strided passes over the bodies to Integrate's one,
+	// tests/IntegrateBench.cpp times the two against each other
+	void IntegrateSIMD( std::vector<RigidBody2D>& vBodies, float fDT );
+
+	size_t Size() const;
+
+	// SoA access, indexed by handle
+	const float * PosX() const;
+	const float * PosY() const;
+	const float * VelX() const;
+	const float * VelY() const;
+
+	// Radius for circles, half width / height for boxes
+	const float * ExtX() const;
+	const float * ExtY() const;
+
+	// 0 for immovable bodies, and 1 or 0 for active and awake
+	const float * InvMass() const;
+	const float * Active() const;
+
+private:
+	void resize( size_t N );
+	void load( const std::vector<RigidBody2D>& vBodies );
+	void integrateArrays( float fDT );
+	void store( std::vector<RigidBody2D>& vBodies ) const;
+
+	std::vector<float> m_vPosX, m_vPosY;
+	std::vector<float> m_vVelX, m_vVelY;
+	std::vector<float> m_vForceX, m_vForceY;	// Only filled by IntegrateSIMD
+	std::vector<float> m_vInvMass;
+	std::vector<float> m_vActive;	// 1 or 0, so it can scale dt
+	std::vector<float> m_vExtX, m_vExtY;
+};
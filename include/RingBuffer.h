@@ -0,0 +1,49 @@
+#pragma once
+
+#include "GL_Util.h"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// A GL buffer for data that gets rewritten every frame. It's split into
+// kNumRegions regions, so the CPU can write one while the GPU reads the
+// others. With GL 4.4 (or ARB_buffer_storage) the buffer stays mapped
+// and each region is guarded by a fence. Otherwise writes go to a
+// staging copy, which is uploaded into an orphaned buffer on Unmap.
+// Call Destroy while the GL context is still around
+class RingBuffer
+{
+public:
+	static const int kNumRegions = 3;
+
+	RingBuffer();
+	bool Init( size_t uRegionBytes );
+	void Destroy();
+
+	// Map gives somewhere to write uBytes for this frame, Unmap returns
+	// where in the buffer they went. Fence goes after the draws that
+	// read them, and moves on to the next region
+	void * Map( size_t uBytes );
+	size_t Unmap();
+	void Fence();
+
+	GLuint GetBuffer() const;
+	bool GetIsPersistent() const;
+	int GetNumStalls() const;	// Frames that had to wait on the GPU
+
+private:
+	bool allocate( size_t uRegionBytes );
+	bool waitForRegion( int ixRegion );
+
+	bool m_bPersistent;
+	GLuint m_Buffer;
+	size_t m_uRegionBytes;
+	size_t m_uMappedBytes;
+	int m_ixRegion;
+	uint8_t * m_pMapped;
+	std::array<GLsync, kNumRegions> m_aFences;
+	std::vector<uint8_t> m_vStaging;	// Only without persistent mapping
+	int m_nStalls;
+};
\ No newline at end of file
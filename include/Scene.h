@@ -6,6 +6,14 @@
 #include "Shader.h"
 #include "Drawable.h"
 #include "Contact.h"
+#include "ContactCache.h"
+#include "CollisionBank.h"
+#include "IslandGraph.h"
+#include "JobPool.h"
+#include "Broadphase.h"
+#include "DynamicTree.h"
+#include "RigidBodyStore.h"
+#include "RingBuffer.h"
 #include "Util.h"
 
 #include <vector>
@@ -13,20 +21,89 @@
 
 #include <SDL.h>
 
-#include <unordered_map>
-
-using ColPair = std::pair<Shape *, Shape *>;
-using ColBank = std::unordered_map < ColPair, bool, pair_hash<ColPair>, pair_hash_eq<ColPair>>;
-
 class Scene
 {
 public:
+	// Which broadphase finds rigid body pairs
+	enum class EBroadphase : int
+	{
+		SortAndSweep,
+		UniformGrid
+	};
+
+	// How contacts get solved. Islands solves each island of
+	// touching bodies on its own, spread over the job pool
+	enum class ESolver : int
+	{
+		Serial,
+		Islands
+	};
+
 	Scene();
 	~Scene();
 
 	void Draw();
 	void Update();
 
+	// Advance exactly nSteps physics steps in one call. Forces applied
+	// beforehand act on every step, events compare the state before
+	// the first step with the state after the last
+	void Step( int nSteps );
+
+	// Force field applied on every step, on top of any forces applied
+	// from Python. Gravity is an acceleration, an attractor pulls with
+	// strength / max( fMinDist2, distance^2 ) regardless of mass
+	void SetGravity( vec2 v2Gravity );
+	vec2 GetGravity() const;
+	int AddAttractor( vec2 v2Pos, float fStrength, float fMinDist2 );
+	void SetAttractorPos( int ixAttractor, vec2 v2Pos );
+	void SetAttractorActive( int ixAttractor, bool bActive );
+	void ClearAttractors();
+
+	// Headless scenes only do physics: there's no display, Draw does
+	// nothing and drawables can't be added (so planes don't get one).
+	// Set it before adding anything
+	void SetHeadless( bool bHeadless );
+	bool GetHeadless() const;
+
+	// A drawable bound to a body gets the body's position copied over
+	// after every Update or Step, so scripts don't have to. Bind once
+	// when the entity is made. False if either index is out of range
+	bool BindRigidBodyDrawable( int ixRigidBody, int ixDrawable );
+	bool BindSoftBodyDrawable( int ixSoftBody, int ixDrawable );
+	void UnbindDrawable( int ixDrawable );
+
+	// Instanced drawing: drawables sharing a mesh get drawn with one
+	// call, their transforms and colors uploaded to an instance buffer.
+	// Needs attribute divisors (GL 3.3 or ARB_instanced_arrays) and the
+	// pos handle set. With it off each drawable gets its own call, still
+	// reading from the instance buffer. Without divisors each drawable
+	// is drawn on its own with uniforms
+	bool InitInstancing( std::string strVertSrc, std::string strFragSrc );
+	void SetInstancedDraw( bool bInstanced );
+	bool GetInstancedDraw() const;
+	int GetNumDrawCalls() const;	// During the last Draw
+
+	// Instance data goes through a triple buffered ring, persistently
+	// mapped if GL allows. Stalls count frames that waited on the GPU
+	bool GetPersistentMapping() const;
+	int GetNumStalledFrames() const;
+
+	// Update runs fixed steps of this length, as many as the real time
+	// since the last Update covers (up to the substep cap), or exactly
+	// one if real time is off. Draw interpolates between the last two
+	// steps, for drawables bound to a rigid body
+	void SetTimeStep( float fDT );
+	float GetTimeStep() const;
+	void SetMaxSubsteps( int nMaxSubsteps );
+	int GetMaxSubsteps() const;
+	void SetRealTime( bool bRealTime );
+	bool GetRealTime() const;
+	void SetInterpolate( bool bInterpolate );
+	bool GetInterpolate() const;
+	int GetLastSubsteps() const;	// Steps the last Update ran
+	float GetInterpAlpha() const;	// How far Draw is between them
+
 	void SetQuitFlag( bool bQuit );
 	bool GetQuitFlag() const;
 
@@ -38,10 +115,92 @@ public:
 
 	bool GetIsColliding( Shape * pA, Shape * pB ) const;
 
+	// Collision begin / persist / end events from the last update, one
+	// per pair at most: they compare the bank from before the update's
+	// first substep with the one after its last, so contacts that came
+	// and went in between don't show up. The span's keys are the
+	// bank's, Python gets four ints per event:
+	// type, rigid body A, body B, and 1 if B is a soft body (else 0)
+	Span<const CollisionEvent> GetCollisionEventSpan() const;
+	std::vector<int> GetCollisionEvents() const;
+
+	void SetBroadphase( EBroadphase eBroadphase );
+	EBroadphase GetBroadphase() const;
+
+	// Solver iteration cap, and how many the last step actually took
+	void SetSolverIterations( int nIterations );
+	int GetSolverIterations() const;
+	int GetLastSolverIterations() const;
+
+	void SetSolverMode( ESolver eSolver );
+	ESolver GetSolverMode() const;
+
+	// Iterations each island took during the last island solve
+	std::vector<int> GetIslandIterations() const;
+
+	// How much of last step's impulse contacts start with (0 turns it off)
+	void SetWarmStartFactor( float fFactor );
+	float GetWarmStartFactor() const;
+	int GetNumWarmStarted() const;
+
+	// Whether the narrowphase uses the batched SIMD kernels
+	void SetBatchNarrowphase( bool bBatch );
+	bool GetBatchNarrowphase() const;
+
+	// Whether integration goes through the SoA store's SSE / AVX loop
+	// (gather, integrate, scatter) instead of one pass over the bodies.
+	// Off by default, the single pass measured faster
+	void SetSIMDIntegrate( bool bSIMD );
+	bool GetSIMDIntegrate() const;
+
+	// Whether the narrowphase sorts pairs by type pair first, so each
+	// shape function (or kernel) runs over a batch of one kind. This
+	// changes the contact order, so results differ a little from unsorted
+	void SetBucketNarrowphase( bool bBucket );
+	bool GetBucketNarrowphase() const;
+
+	// Threads used for the narrowphase (1 is serial, 0 is one per core)
+	void SetThreadCount( int nThreads );
+	int GetThreadCount() const;
+
+	// Sleeping. Bodies whose island has stayed under the energy
+	// threshold for the given time stop being simulated until woken
+	void SetSleepEnabled( bool bSleepEnabled );
+	bool GetSleepEnabled() const;
+	void SetSleepEnergy( float fEnergy );
+	void SetTimeToSleep( float fSeconds );
+	int GetNumAsleep() const;
+	int GetNumSlept() const;	// During the last update
+	int GetNumWoken() const;	// During the last update
+	int GetNumIslands() const;
+
+	// How close (after this step's motion) a body has to get to a
+	// plane before they get a contact, and how many contacts that made
+	void SetPlaneMargin( float fMargin );
+	float GetPlaneMargin() const;
+	int GetNumPlaneContacts() const;
+
+	// Contact culling. Contacts further apart than their closing speed
+	// covers in a step (plus the margin) are dropped before solving
+	void SetCullContacts( bool bCull );
+	bool GetCullContacts() const;
+	void SetCullMargin( float fMargin );
+	float GetCullMargin() const;
+	int GetNumCulledContacts() const;	// During the last update
+
+	// Broadphase stats from the last update
+	int GetNumBroadphasePairs() const;
+	int GetNumBodyPairs() const;
+
+	// Soft body tree stats
+	int GetSoftTreeHeight() const;
+	int GetSoftTreeNodeCount() const;
+
 	const Plane * GetPlane( const size_t planeIdx ) const;
 	const Shader * GetShaderPtr() const;
 	const Camera * GetCameraPtr() const;
-	std::list<Contact *> GetContacts() const;
+	std::vector<Contact *> GetContacts();
+	Span<const Contact> GetContactSpan() const;
 	const Drawable * GetDrawable( const size_t drIdx ) const;
 	const RigidBody2D * GetRigidBody2D( const size_t rbIdx ) const;
 	const SoftBody2D * GetSoftBody2D( const size_t sbIdx ) const;
@@ -54,7 +213,78 @@ public:
 	int AddRigidBody(Shape::EType eType, glm::vec2 v2Vel, glm::vec2 v2Pos, float fMass, float fElasticity, std::map<std::string, float> mapDetails );
 	int AddCollisionPlane( glm::vec2 N, float d );
 private:
+	// What the instanced shader reads per instance
+	struct InstanceData
+	{
+		mat4 m4MV;
+		vec4 v4Color;
+	};
+
+	// Active drawables sharing a VAO, a run of the instance data
+	struct InstanceGroup
+	{
+		const Drawable * pDrawable;
+		uint32_t uOffset;
+		uint32_t uCount;
+	};
+
+	struct DrawableBinding
+	{
+		uint32_t uBody;
+		uint32_t uDrawable;
+		bool bSoft;
+	};
+
+	struct Attractor
+	{
+		bool bActive;
+		vec2 v2Pos;
+		float fStrength;
+		float fMinDist2;
+	};
+
+	// What each narrowphase job writes, merged afterward
+	struct NarrowphaseChunk
+	{
+		std::vector<Contact> vContacts;
+		std::vector<BodyPair> vIslandLinks;
+		std::vector<BodyPair> vHeldPairs;	// Skipped pairs with a sleeper in them
+
+		// Circle pairs for the batch kernel, and where their contacts go
+		std::vector<BodyPair> vCirclePairs;
+		std::vector<uint32_t> vCircleSlots;
+		std::vector<Contact> vCircleContacts;
+
+		// Same for box pairs
+		std::vector<BodyPair> vBoxPairs;
+		std::vector<uint32_t> vBoxSlots;
+		std::vector<Contact> vBoxContacts;
+
+		// Pairs waiting to be sorted by type pair
+		std::vector<BodyPair> vBucketPairs;
+	};
+
+	void step( const CollisionBank& lastBank );
+	void runSteps( int nSteps );
+	void bucketNarrowphase();
+	void cullContacts();
+
+	// Soft body handles get this bit in the collision bank
+	static const uint32_t kSoftBankKey = 1u << 31;
+	uint32_t getBankKey( const Shape * pShape ) const;
+
+	void updateSoftBodyTree();
+	void syncDrawables();
+	mat4 getDrawableMV( size_t ixDrawable, bool bInterpolate ) const;
+	void drawInstanced( const mat4& P, bool bInterpolate, bool bGroupByMesh );
+	void bindInstanceAttribs( size_t uOffset );
+	void applyForceField();
+	void wakeForcedBodies();
+	void buildIslands();
+	void updateSleep();
+
 	bool m_bQuitFlag;
+	bool m_bHeadless;
 	bool m_bDrawContacts;
 	bool m_bPauseCollision;
 	SDL_GLContext m_GLContext;
@@ -62,10 +292,68 @@ private:
 	Shader m_Shader;
 	Camera m_Camera;
 	std::vector<Drawable> m_vDrawables;
+	std::vector<DrawableBinding> m_vDrawableBindings;
+	Shader m_InstShader;
+	bool m_bInstancedDraw;
+	bool m_bCanInstance;	// Attribute divisors and the instanced shader are ready
+	RingBuffer m_InstanceRing;
+	std::vector<InstanceGroup> m_vInstanceGroups;
+	std::vector<uint32_t> m_vInstanceGroupOf;	// Drawable -> group
+	int m_nDrawCalls;
 	std::vector<SoftBody2D> m_vSoftBodies;
 	std::vector<RigidBody2D> m_vRigidBodies;
+	RigidBodyStore m_BodyStore;
 	std::vector<Plane> m_vCollisionPlanes;
-	std::list<Contact> m_liSpeculativeContacts;
+	std::vector<Contact> m_vSpeculativeContacts;	// Keeps its capacity between steps
+	EBroadphase m_eBroadphase;
+	SortAndSweep m_SortAndSweep;
+	SpatialHashGrid m_SpatialHash;
+	DynamicTree m_SoftBodyTree;
+	std::vector<int> m_vSoftBodyProxies;
 	Contact::Solver m_ContactSolver;
-	ColBank m_CollisionBank;
+	ContactCache m_ContactCache;
+	float m_fWarmStartFactor;
+	ESolver m_eSolver;
+	bool m_bBatchNarrowphase;
+	bool m_bBucketNarrowphase;
+	bool m_bSIMDIntegrate;
+	float m_fPlaneMargin;
+	int m_nPlaneContacts;
+	std::vector<uint32_t> m_vPlaneCandidates;
+	bool m_bCullContacts;
+	float m_fCullMargin;
+	int m_nCulled;
+	float m_fTimeStep;
+	int m_nMaxSubsteps;
+	bool m_bRealTime;
+	bool m_bInterpolate;
+	bool m_bFirstUpdate;
+	Time::time_point m_tLastUpdate;
+	float m_fAccumulator;
+	float m_fInterpAlpha;
+	int m_nLastSubsteps;
+	std::vector<vec2> m_vFrameForces;	// What Python applied this frame
+	std::vector<vec2> m_vPrevPositions;	// Before the last step
+	std::vector<int> m_vBodyOfDrawable;	// Drawable -> bound rigid body or -1, for Draw
+	vec2 m_v2Gravity;
+	std::vector<Attractor> m_vAttractors;
+	IslandGraph m_IslandGraph;
+	std::vector<uint32_t> m_vContactIsland;			// Contact -> island
+	std::vector<uint32_t> m_vIslandContacts;		// Contact indices grouped by island
+	std::vector<uint32_t> m_vIslandContactStart;	// Where each island starts in ^
+	std::vector<uint32_t> m_vIslandContactCount;	// Per island contact count, then write cursor
+	std::vector<BodyPair> m_vIslandLinks;	// Sleeping pairs that got no contact
+	JobPool m_JobPool;
+	std::vector<NarrowphaseChunk> m_vNarrowphaseChunks;
+	std::vector<BodyPair> m_vBucketPairs;	// Merged from the chunks
+	std::vector<BodyPair> m_vSortedPairs;	// The same, by type pair
+	bool m_bSleepEnabled;
+	float m_fSleepEnergy;
+	float m_fTimeToSleep;
+	int m_nSlept;
+	int m_nWoken;
+	CollisionBank m_CollisionBank;
+	CollisionBank m_PrevCollisionBank;	// As of the last Update or Step
+	CollisionBank m_LastStepBank;		// As of the last substep, within an Update or Step
+	std::vector<CollisionEvent> m_vCollisionEvents;
 };
@@ -4,12 +4,29 @@
 
 #include <string>
 #include <map>
+#include <array>
 
 class Shader
 {
 public:
+	// Variables the engine uses every frame. Init resolves
+	// them into a flat table, so lookups don't touch strings
+	enum class EHandle : int
+	{
+		PMV,		// u_PMV
+		Color,		// u_Color
+		CamMat,		// u_CamMat
+		Pos,		// a_Pos
+		MV,			// a_MV
+		InstColor,	// a_Color
+		Count
+	};
+
 	Shader();
 	bool Init( std::string strVertSrc, std::string strFragSrc, bool fromDisk );
+
+	// Pin an attribute to a location, call before Init
+	void BindAttribLocation( const std::string strVarName, GLint iLocation );
 	
 	// Bound status
 	bool Bind();
@@ -25,6 +42,8 @@ public:
 
 	// Public Accessors
 	GLint GetHandle( const std::string strVarName );
+	GLint GetHandle( EHandle eHandle ) const;	// -1 if the program doesn't use it
+	GLint GetHandleByID( int ixHandle ) const;	// For Python, takes an EHandle
 
 	// Scoped bind class
 	class ScopedBind
@@ -46,4 +65,6 @@ private:
 	GLuint m_hFragShader;
 	std::string m_VertShaderSrc, m_FragShaderSrc;
 	std::map<std::string, GLint> m_mapHandles;
+	std::array<GLint, (size_t) EHandle::Count> m_aHandles;
+	std::map<std::string, GLint> m_mapAttribLocations;
 };
\ No newline at end of file
@@ -4,9 +4,12 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <utility>
 
 // Smol
 const float kEPS = 0.001f;
+
+// Default physics step, the Scene's can be changed at runtime
 const float g_fTimeStep = 0.005f;
 const float g_fInvTimeStep = 1.f / 0.005f;
 
@@ -45,41 +48,27 @@ public:
 	}
 };
 
-// Const ptr type
+// Non owning view of contiguous memory (until we have std::span)
 template<typename T>
-using const_ptr = const T * const;
-
-// Used for hashing pairs
-template<typename P>
-struct pair_hash
+struct Span
 {
-	template <class T>
-	static inline void hash_combine( std::size_t & seed, const T& v )
-	{
-		std::hash<T> hasher;
-		seed ^= hasher( v ) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-	}
+	T * pBegin;
+	T * pEnd;
 
-	size_t operator()( const P& p ) const
-	{
-		std::size_t seed1 = 0;
-		hash_combine( seed1, p.first );
-		hash_combine( seed1, p.second );
+	Span() : pBegin( nullptr ), pEnd( nullptr ) {}
+	Span( T * pB, T * pE ) : pBegin( pB ), pEnd( pE ) {}
 
-		std::size_t seed2 = 0;
-		hash_combine( seed2, p.second );
-		hash_combine( seed2, p.first );
+	// Anything with data() and size(), i.e. std::vector
+	template<typename C, typename = decltype( std::declval<C&>().data() )>
+	Span( C& container ) : pBegin( container.data() ), pEnd( container.data() + container.size() ) {}
 
-		size_t ret = std::min( seed1, seed2 );
-		return ret;
-	}
+	T * begin() const { return pBegin; }
+	T * end() const { return pEnd; }
+	size_t size() const { return pEnd - pBegin; }
+	bool empty() const { return pBegin == pEnd; }
+	T& operator[]( size_t i ) const { return pBegin[i]; }
 };
 
-template <typename P>
-struct pair_hash_eq
-{
-	bool operator()( const P& a, const P& b ) const
-	{
-		return pair_hash<P>()(a) == pair_hash<P>()(b);
-	}
-};
\ No newline at end of file
+// Const ptr type
+template<typename T>
+using const_ptr = const T * const;
@@ -0,0 +1,51 @@
+# Physics only scene, run with --headless. There's no
+# window or GL context, so there are no drawables either
+
+# Custom pyl modules
+import pylScene
+import pylShape
+
+import random
+
+# How many steps each Update call runs, and how many in total
+nStepsPerUpdate = 1000
+nTotalSteps = 100000
+nStepsTaken = 0
+
+g_liBodies = []
+
+# Initialize the scene
+def Initialize(pScene):
+    # construct pyl scene
+    cScene = pylScene.Scene(pScene)
+    cScene.SetRealTime(False)
+
+    # Gravity is applied in C++ on every step
+    cScene.SetGravity([0., -75.])
+
+    # A box of walls, same as main.py
+    walls = [[1., 0.], [-1., 0.], [0., 1.], [0., -1.]]
+    d = -8.
+    for N in walls:
+        cScene.AddCollisionPlane(N, d)
+
+    # Scatter some boxes and circles around
+    for i in range(64):
+        pos = [random.uniform(-7, 7), random.uniform(-7, 7)]
+        if i % 2:
+            rbIdx = cScene.AddRigidBody(pylShape.Circle, [0, 0], pos, 1, 1, {'r' : .5})
+        else:
+            rbIdx = cScene.AddRigidBody(pylShape.AABB, [0, 0], pos, 1, 1, {'w' : 1, 'h' : 1})
+        if rbIdx < 0:
+            raise RuntimeError('Error creating rigid body')
+        g_liBodies.append(rbIdx)
+
+# Run a batch of steps without coming back to Python
+def Update(pScene):
+    cScene = pylScene.Scene(pScene)
+
+    global nStepsTaken
+    cScene.Step(nStepsPerUpdate)
+    nStepsTaken += nStepsPerUpdate
+    if nStepsTaken >= nTotalSteps:
+        cScene.SetQuitFlag(True)
@@ -28,6 +28,7 @@ g_liEnts = []
 g_liPlanes = []
 g_InputManager = InputManager.InputManager(None, None, None)
 g_SoftMouseManager = None
+g_ixAttractor = -1
 
 # Used to construct ctypes sdl2 object
 # from pointer to object in C++
@@ -69,6 +70,9 @@ class Entity:
         self.rbIdx = rbIdx
         self.drIdx = drIdx
 
+        # The scene keeps the drawable on the rigid body from now on
+        cScene.BindRigidBodyDrawable(rbIdx, drIdx)
+
         # Set entity IDs
         self.nID = Entity.nEntsCreated
         self.GetDrawableComponent().SetID(Entity.nEntsCreated)
@@ -82,28 +86,6 @@ class Entity:
     def GetCollisionComponent(self):
         return pylRigidBody2D.RigidBody2D(self.cScene.GetRigidBody2D(self.rbIdx))
 
-    def Update(self):
-        # Get position of the collision component
-        c = self.GetCollisionComponent()
-        pos = c.Position()
-
-        global g_InputManager
-        if g_InputManager.mouseMgr.IsButtonPressed(sdl2.SDL_BUTTON_LEFT):
-            # If mouse is down, create an attractive potential
-            worldMousePos = g_InputManager.mouseMgr.fnMouseToWorld(g_InputManager.mouseMgr.mousePos)
-            dist = [p - w for w, p in zip(worldMousePos, pos)]
-            r2_inv = 1. / max(0.1, sum(di**2 for di in dist))
-            F = [-80.*di * r2_inv for di in dist]
-        else:
-            # Otherwise just do gravity
-            F = [0., -75. * c.GetMass()]
-
-        # Apply force
-        c.ApplyForce(F)
-
-        # Update drawable transform
-        self.GetDrawableComponent().SetPos2D(pos)
-
 # Doesn't do a whole lot for now
 class Plane:
     def __init__(self, cScene, N, d):
@@ -190,12 +172,16 @@ def Initialize(pScene):
         raise RuntimeError('Error initializing Shader')
 
     # Set up camera
-    pylCamera.SetCamMatHandle(cShader.GetHandle('u_PMV'))
+    pylCamera.SetCamMatHandle(cShader.GetHandleByID(pylShader.HandlePMV))
     cCamera = pylCamera.Camera(cScene.GetCameraPtr())
     cCamera.InitOrtho(*(screenDims+worldDims))
 
     # Set up static drawable handle
-    pylDrawable.SetPosHandle(cShader.GetHandle('a_Pos'))
+    pylDrawable.SetPosHandle(cShader.GetHandleByID(pylShader.HandlePos))
+
+    # Draw drawables that share a mesh together, if we can
+    if cScene.InitInstancing('../shaders/instanced.vert', '../shaders/instanced.frag') == False:
+        print('Instanced drawing unavailable, drawing one at a time')
 
     # create entities, just two random ones for now
     g_liEnts.append(Entity(cScene,
@@ -228,6 +214,13 @@ def Initialize(pScene):
     for N in walls:
         g_liPlanes.append(Plane(cScene, N, d))
 
+    # Gravity, and an attractive potential at the mouse
+    # that replaces it while the left button is down
+    cScene.SetGravity([0., -75.])
+    global g_ixAttractor
+    g_ixAttractor = cScene.AddAttractor([0., 0.], 80., 0.1)
+    cScene.SetAttractorActive(g_ixAttractor, False)
+
     # Create soft body entities (that follow mouse))
     liSoftEntities = []
     # quad
@@ -346,26 +339,28 @@ def Update(pScene):
     # construct pyl scene
     cScene = pylScene.Scene(pScene)
 
-    # Update entities, which updates drawable
-    global g_liEnts
-    for e in g_liEnts:
-        e.Update()
-
-    # Update and draw scene
+    # Swap gravity for the mouse attractor while the button's down
+    global g_InputManager
+    if g_InputManager.mouseMgr.IsButtonPressed(sdl2.SDL_BUTTON_LEFT):
+        worldMousePos = g_InputManager.mouseMgr.fnMouseToWorld(g_InputManager.mouseMgr.mousePos)
+        cScene.SetAttractorPos(g_ixAttractor, worldMousePos)
+        cScene.SetAttractorActive(g_ixAttractor, True)
+        cScene.SetGravity([0., 0.])
+    else:
+        cScene.SetAttractorActive(g_ixAttractor, False)
+        cScene.SetGravity([0., -75.])
+
+    # Update and draw scene, which moves the entity drawables
     cScene.Update()
     cScene.Draw()
 
-    for i in range(len(g_liEnts)):
-        for sb in g_SoftMouseManager.liSoftEntities:
-            p1 = sb.GetSoftBody().c_ptr
-            p2 = g_liEnts[i].GetCollisionComponent().c_ptr
-            if cScene.GetIsColliding(p1, p2):
-                print('soft')
-        for j in range(i+1, len(g_liEnts)):
-            p1 = g_liEnts[i].GetCollisionComponent().c_ptr
-            p2 = g_liEnts[j].GetCollisionComponent().c_ptr
-            if cScene.GetIsColliding(p2, p1):
-                print('hard')
+    # Collision events come four ints at a time: type,
+    # rigid body index, other body index, and whether it's soft
+    events = cScene.GetCollisionEvents()
+    for i in range(0, len(events), 4):
+        eType, ixA, ixB, bSoft = events[i:i+4]
+        if eType != pylScene.CollisionEnd:
+            print('soft' if bSoft else 'hard')
 
 # Handle SDL2 events
 def HandleEvent(pSdlEvent, pScene):
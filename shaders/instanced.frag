@@ -0,0 +1,7 @@
+#version 120
+
+varying vec4 v_Color;
+
+void main(){
+	gl_FragColor = v_Color;
+}
\ No newline at end of file
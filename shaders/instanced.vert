@@ -0,0 +1,16 @@
+#version 120
+
+uniform mat4 u_CamMat;
+
+attribute vec3 a_Pos;
+
+// Per instance
+attribute mat4 a_MV;
+attribute vec4 a_Color;
+
+varying vec4 v_Color;
+
+void main(){
+	v_Color = a_Color;
+	gl_Position = u_CamMat * a_MV * vec4(a_Pos, 1.0);
+}
\ No newline at end of file
@@ -118,168 +118,33 @@ glm::vec2 AABB::GetFaceNormalFromPoint( const glm::vec2 p ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
-// This is rather verbose, but it gets the job done
+// Everything falls out of the gap between the boxes on each axis
+// (positive when apart). If both gaps are positive it's a corner to
+// corner contact, otherwise the axis with the bigger gap (the least
+// penetration, if they overlap) gives a face contact. The contact
+// points sit at the middle of the facing sides, or the facing corners,
+// which are just the centers pushed out by the half extents. Everything
+// is a select rather than a branch, see GetBoxContacts for the batch
 Contact GetSpecContact( AABB * pA, AABB * pB )
 {
-	// Contact normal and indices from each box
-	vec2 n;
-	int vIdxA, vIdxB;
+	vec2 d = pB->v2Center - pA->v2Center;
+	vec2 s( d.x < 0 ? -1.f : 1.f, d.y < 0 ? -1.f : 1.f );
+	vec2 g = glm::abs( d ) - (pA->v2HalfDim + pB->v2HalfDim);
 
-	// Get the overlap directions
-	bool bX = IsOverlappingX( pA, pB );
-	bool bY = IsOverlappingY( pA, pB );
+	bool bCorner = g.x > 0 && g.y > 0;
+	bool bUseX = g.x > g.y;
 
-	// If we have a genuine overlap, then I haven't done my job...
-	if ( bX && bY )
-	{
-		// Find the direction of least penetration (X or Y),
-		// take A's face in that direction to be the collision normal
-		float fPenX( 0 ), fPenY( 0 );
-		int vIdxAX( 0 ), vIdxAY( 0 ), vIdxBX( 0 ), vIdxBY( 0 );
-		vec2 v2NrmX, v2NrmY;
-
-		// Determine which direction the overlap occurs in X
-		if ( pA->Right() > pB->Left() && pA->Left() < pB->Right() )
-		{
-			// A is overlapping B from the left
-			fPenX = std::min( 0.f, pB->Left() - pA->Right() );
-			v2NrmX = vec2( 1, 0 );
-			vIdxAX = 0;
-			vIdxBX = 2;
-		}
-		else
-		{
-			// A is overlapping B from the right
-			fPenX = std::min( 0.f, pA->Left() - pB->Right() );
-			v2NrmX = vec2( -1, 0 );
-			vIdxAX = 2;
-			vIdxBX = 0;
-		}
-
-		// Determine which direction the overlap occurs in X
-		if ( pA->Top() > pB->Bottom() && pA->Bottom() < pB->Top() )
-		{
-			// A is overlapping B from below
-			fPenY = std::min( 0.f, pB->Bottom() - pA->Top() );
-			v2NrmY = vec2( 0, 1 );
-			vIdxAY = 3;
-			vIdxBY = 1;
-		}
-		else
-		{
-			// A is overlapping B from above
-			fPenY = std::min( 0.f, pA->Bottom() - pB->Top() );
-			v2NrmY = vec2( 0, -1 );
-			vIdxAY = 1;
-			vIdxBY = 3;
-		}
-
-		// Pick the least penetration distance
-		// The penetration distances are <= 0,
-		// and we want the one closest to 0
-		if ( fPenX > fPenY )
-		{
-			// X penetrates less than Y
-			n = v2NrmX;
-			vIdxA = vIdxAX;
-			vIdxB = vIdxBX;
-		}
-		else
-		{
-			// the other way around
-			n = v2NrmY;
-			vIdxA = vIdxAY;
-			vIdxB = vIdxBY;
-		}
-	}
-	// We're overlapping X, worry about vertical collisions
-	else if ( bX )
-	{
-		// If We're below
-		if ( pA->Top() <= pB->Bottom() )
-		{
-			// top of A, bottpm of B
-			n = vec2( 0, 1 );
-			vIdxA = 3;
-			vIdxB = 1;
-		}
-		else
-		{
-			// bottom of A, top of B
-			n = vec2( 0, -1 );
-			vIdxA = 1;
-			vIdxB = 3;
-		}
-	}
-	// We're overlapping Y, worry about horizontal collisions
-	else if ( bY )
-	{
-		if ( pA->Right() < pB->Left() )
-		{
-			// right of A, left of B
-			n = vec2( 1, 0 );
-			vIdxA = 0;
-			vIdxB = 2;
-		}
-		else
-		{
-			// left of A, right of B
-			n = vec2( -1, 0 );
-			vIdxA = 2;
-			vIdxB = 0;
-		}
-	}
-	else
-	{
-		// If we aren't overlapping in either direction
-		// handle a potential corner collision
-		bool bAIsLeft = (pA->Right() < pB->Left());
-		bool bAIsBelow = (pA->Top() < pB->Bottom());
-		if ( bAIsLeft )
-		{
-			if ( bAIsBelow )
-			{
-				// Top right of A, bottom left of B
-				vIdxA = 0;
-				vIdxB = 2;
-			}
-			else
-			{
-				// Bottom right of A, top left of B
-				vIdxA = 1;
-				vIdxB = 3;
-			}
-		}
-		else
-		{
-			if ( bAIsBelow )
-			{
-				// Top left of A, bottom right of B
-				vIdxA = 3;
-				vIdxB = 1;
-			}
-			else
-			{
-				// Bottom left of A, top right of B
-				vIdxA = 2;
-				vIdxB = 0;
-			}
-		}
-
-		// We don't need to average contact positions for the corner case
-		vec2 posA = GetVert( pA, vIdxA );
-		vec2 posB = GetVert( pB, vIdxB );
-		n = glm::normalize( posB - posA );
-		float fDist = glm::distance( posA, posB );
-		return Contact( (RigidBody2D *) pA, (RigidBody2D *) pB, posA, posB, n, fDist );
-	}
+	// Which axes the contact points get pushed along
+	vec2 m( bCorner || bUseX ? 1.f : 0.f, bCorner || bUseX == false ? 1.f : 0.f );
+
+	// Corners point from corner to corner, faces along one axis
+	vec2 a( bCorner ? g.x : m.x, bCorner ? g.y : m.y );
+	float fLen = sqrtf( a.x * a.x + a.y * a.y );
+	vec2 n = (s * a) * (1.f / fLen);
+	float fDist = bCorner ? fLen : (bUseX ? g.x : g.y);
 
-	// For the face case, we get the two vertices from each colliding face
-	// and average them per face, so that the collision is not diminished
-	// by the radius arm of the contact. Distance is along direction of normal
-	vec2 posA = 0.5f * (GetVert( pA, vIdxA ) + GetVert( pA, vIdxA + 1 ));
-	vec2 posB = 0.5f * (GetVert( pB, vIdxB ) + GetVert( pB, vIdxB + 1 ));
-	float fDist = glm::dot( n, posB - posA );
+	vec2 posA = pA->v2Center + s * m * pA->v2HalfDim;
+	vec2 posB = pB->v2Center - s * m * pB->v2HalfDim;
 	return Contact( (RigidBody2D *) pA, (RigidBody2D *) pB, posA, posB, n, fDist );
 }
 
@@ -0,0 +1,336 @@
+#include "Broadphase.h"
+#include "RigidBody2D.h"
+#include "GL_Util.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////
+
+bool Bounds::IsOverlapping( const Bounds& other ) const
+{
+	if ( v2Max.x < other.v2Min.x || v2Min.x > other.v2Max.x )
+		return false;
+	if ( v2Max.y < other.v2Min.y || v2Min.y > other.v2Max.y )
+		return false;
+	return true;
+}
+
+void Bounds::Merge( const Bounds& other )
+{
+	v2Min = glm::min( v2Min, other.v2Min );
+	v2Max = glm::max( v2Max, other.v2Max );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Bounds GetBounds( const Shape * pShape )
+{
+	using EType = Shape::EType;
+	switch ( pShape->eType )
+	{
+		case EType::Circle:
+		{
+			vec2 R( pShape->fRadius );
+			return{ pShape->v2Center - R, pShape->v2Center + R };
+		}
+		case EType::AABB:
+			return{ pShape->v2Center - pShape->v2HalfDim, pShape->v2Center + pShape->v2HalfDim };
+		case EType::Triangle:
+		{
+			const Triangle * pT = (const Triangle *) pShape;
+			return{ vec2( pT->Left(), pT->Bottom() ), vec2( pT->Right(), pT->Top() ) };
+		}
+		default:
+			break;
+	}
+
+	return{ pShape->v2Center, pShape->v2Center };
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Bounds GetSweptBounds( const RigidBody2D * pRB, float fDT )
+{
+	// Union of where we are and where we'll be
+	Bounds bNow = GetBounds( pRB );
+	Bounds bNext = bNow;
+	vec2 v2Disp = fDT * pRB->v2Vel;
+	bNext.v2Min += v2Disp;
+	bNext.v2Max += v2Disp;
+	bNow.Merge( bNext );
+	return bNow;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+SortAndSweep::SortAndSweep() :
+	m_uNumSwaps( 0 )
+{}
+
+void SortAndSweep::Update( const std::vector<RigidBody2D>& vBodies, float fDT )
+{
+	m_vPairs.clear();
+	m_uNumSwaps = 0;
+
+	// Bodies are never removed, so just tack new ones on the end
+	for ( uint32_t i = (uint32_t) m_vOrder.size(); i < vBodies.size(); i++ )
+		m_vOrder.push_back( i );
+
+	// Recompute swept bounds
+	m_vBounds.resize( vBodies.size() );
+	for ( size_t i = 0; i < vBodies.size(); i++ )
+		m_vBounds[i] = GetSweptBounds( &vBodies[i], fDT );
+
+	// Insertion sort on min x, which is nearly sorted from last frame
+	for ( size_t i = 1; i < m_vOrder.size(); i++ )
+	{
+		uint32_t uIdx = m_vOrder[i];
+		float fMinX = m_vBounds[uIdx].v2Min.x;
+		size_t j = i;
+		for ( ; j > 0 && m_vBounds[m_vOrder[j - 1]].v2Min.x > fMinX; j-- )
+		{
+			m_vOrder[j] = m_vOrder[j - 1];
+			m_uNumSwaps++;
+		}
+		m_vOrder[j] = uIdx;
+	}
+
+	// Sweep - everything overlapping in x is between i and
+	// the first body whose min x is past i's max x
+	for ( size_t i = 0; i < m_vOrder.size(); i++ )
+	{
+		uint32_t uA = m_vOrder[i];
+		if ( vBodies[uA].GetIsActive() == false )
+			continue;
+
+		const Bounds& bA = m_vBounds[uA];
+		for ( size_t j = i + 1; j < m_vOrder.size(); j++ )
+		{
+			uint32_t uB = m_vOrder[j];
+			const Bounds& bB = m_vBounds[uB];
+			if ( bB.v2Min.x > bA.v2Max.x )
+				break;
+
+			if ( vBodies[uB].GetIsActive() == false )
+				continue;
+
+			// We know x overlaps, check y
+			if ( bA.v2Max.y < bB.v2Min.y || bA.v2Min.y > bB.v2Max.y )
+				continue;
+
+			m_vPairs.emplace_back( std::min( uA, uB ), std::max( uA, uB ) );
+		}
+	}
+}
+
+const std::vector<BodyPair>& SortAndSweep::GetPairs() const
+{
+	return m_vPairs;
+}
+
+uint32_t SortAndSweep::GetNumSwaps() const
+{
+	return m_uNumSwaps;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// Most proxies touch at most four cells, anything
+// touching more than this is tested against everything
+static const float kMaxCells = 16.f;
+
+// Cell coords that survive the cast to int32, with room for the binning
+// loop to step one past the max. Both are exact floats: -2^31 and 2^31 - 128
+static const float kMinCell = -2147483648.f;
+static const float kMaxCell = 2147483520.f;
+
+SpatialHashGrid::SpatialHashGrid() :
+	m_fCellSize( 1.f ),
+	m_uNumRigid( 0 )
+{}
+
+uint32_t SpatialHashGrid::bucketIdx( int32_t iX, int32_t iY ) const
+{
+	// Bucket count is a power of two
+	uint32_t h = (uint32_t) iX * 73856093u ^ (uint32_t) iY * 19349663u;
+	return h & (uint32_t) (m_vBucketStart.size() - 2);
+}
+
+// Soft bodies don't interact with each other, and the bounds have to overlap
+bool SpatialHashGrid::canPair( uint32_t uA, uint32_t uB ) const
+{
+	if ( uA >= m_uNumRigid && uB >= m_uNumRigid )
+		return false;
+	return m_vBounds[uA].IsOverlapping( m_vBounds[uB] );
+}
+
+void SpatialHashGrid::addPair( uint32_t uA, uint32_t uB, int32_t iX, int32_t iY )
+{
+	if ( canPair( uA, uB ) == false )
+		return;
+
+	// A pair can share several cells, only report it from the
+	// cell holding the min corner of the overlapping region
+	vec2 v2Corner = glm::max( m_vBounds[uA].v2Min, m_vBounds[uB].v2Min );
+	if ( (int32_t) floor( v2Corner.x / m_fCellSize ) != iX || (int32_t) floor( v2Corner.y / m_fCellSize ) != iY )
+		return;
+
+	reportPair( uA, uB );
+}
+
+void SpatialHashGrid::reportPair( uint32_t uA, uint32_t uB )
+{
+	if ( uA >= m_uNumRigid )
+		m_vSoftPairs.emplace_back( uA - m_uNumRigid, uB );
+	else if ( uB >= m_uNumRigid )
+		m_vSoftPairs.emplace_back( uB - m_uNumRigid, uA );
+	else
+		m_vPairs.emplace_back( std::min( uA, uB ), std::max( uA, uB ) );
+}
+
+void SpatialHashGrid::Update( const std::vector<RigidBody2D>& vBodies, const std::vector<SoftBody2D>& vSoftBodies, float fDT )
+{
+	m_vPairs.clear();
+	m_vSoftPairs.clear();
+	m_vEntries.clear();
+	m_vExtents.clear();
+	m_vOversized.clear();
+
+	// Compute bounds for every proxy
+	m_uNumRigid = (uint32_t) vBodies.size();
+	size_t nProxies = vBodies.size() + vSoftBodies.size();
+	m_vBounds.resize( nProxies );
+	m_vActive.resize( nProxies );
+	for ( size_t i = 0; i < nProxies; i++ )
+	{
+		if ( i < m_uNumRigid )
+		{
+			m_vActive[i] = vBodies[i].GetIsActive();
+			m_vBounds[i] = GetSweptBounds( &vBodies[i], fDT );
+		}
+		else
+		{
+			m_vActive[i] = vSoftBodies[i - m_uNumRigid].GetIsActive();
+			m_vBounds[i] = GetBounds( &vSoftBodies[i - m_uNumRigid] );
+		}
+
+		if ( m_vActive[i] )
+		{
+			vec2 v2Ext = m_vBounds[i].v2Max - m_vBounds[i].v2Min;
+			m_vExtents.push_back( std::max( v2Ext.x, v2Ext.y ) );
+		}
+	}
+
+	if ( m_vExtents.empty() )
+		return;
+
+	// Cells are as big as the median extent, so most
+	// things touch at most four cells
+	auto itMedian = m_vExtents.begin() + m_vExtents.size() / 2;
+	std::nth_element( m_vExtents.begin(), itMedian, m_vExtents.end() );
+	m_fCellSize = std::max( *itMedian, kEPS );
+
+	// Bin proxies into every cell they touch. A fast body's swept bounds
+	// or a big static box could touch thousands, so past kMaxCells they
+	// go on the oversized list instead, as do proxies whose cells are
+	// outside int32 range (or NaN), which couldn't be cast to cell coords.
+	// All of that is checked in floats, before any cast
+	for ( uint32_t i = 0; i < nProxies; i++ )
+	{
+		if ( m_vActive[i] == false )
+			continue;
+
+		const Bounds& b = m_vBounds[i];
+		float fMinX = floor( b.v2Min.x / m_fCellSize );
+		float fMinY = floor( b.v2Min.y / m_fCellSize );
+		float fMaxX = floor( b.v2Max.x / m_fCellSize );
+		float fMaxY = floor( b.v2Max.y / m_fCellSize );
+		bool bInRange = fMinX >= kMinCell && fMinY >= kMinCell && fMaxX <= kMaxCell && fMaxY <= kMaxCell;
+		if ( bInRange == false || (fMaxX - fMinX + 1) * (fMaxY - fMinY + 1) > kMaxCells )
+		{
+			m_vOversized.push_back( i );
+			continue;
+		}
+
+		int32_t iMinX = (int32_t) fMinX;
+		int32_t iMinY = (int32_t) fMinY;
+		int32_t iMaxX = (int32_t) fMaxX;
+		int32_t iMaxY = (int32_t) fMaxY;
+		for ( int32_t iY = iMinY; iY <= iMaxY; iY++ )
+			for ( int32_t iX = iMinX; iX <= iMaxX; iX++ )
+				m_vEntries.push_back( { iX, iY, i } );
+	}
+
+	// Size the table to twice the entry count (power of two),
+	// with one extra slot so every bucket has an end offset
+	size_t nBuckets = 1;
+	while ( nBuckets < 2 * m_vEntries.size() )
+		nBuckets <<= 1;
+	m_vBucketStart.assign( nBuckets + 1, 0 );
+
+	// Counting sort entries into their buckets
+	for ( const Entry& e : m_vEntries )
+		m_vBucketStart[bucketIdx( e.iX, e.iY ) + 1]++;
+	for ( size_t i = 1; i <= nBuckets; i++ )
+		m_vBucketStart[i] += m_vBucketStart[i - 1];
+
+	m_vSorted.resize( m_vEntries.size() );
+	for ( const Entry& e : m_vEntries )
+	{
+		// Borrow the start offsets as insertion cursors
+		uint32_t& uCursor = m_vBucketStart[bucketIdx( e.iX, e.iY )];
+		m_vSorted[uCursor++] = e;
+	}
+
+	// The cursors now sit at each bucket's end, shift them back
+	for ( size_t i = nBuckets; i > 0; i-- )
+		m_vBucketStart[i] = m_vBucketStart[i - 1];
+	m_vBucketStart[0] = 0;
+
+	// Check everything sharing a bucket (and a cell - buckets can collide)
+	for ( size_t b = 0; b < nBuckets; b++ )
+	{
+		for ( uint32_t i = m_vBucketStart[b]; i < m_vBucketStart[b + 1]; i++ )
+		{
+			const Entry& eA = m_vSorted[i];
+			for ( uint32_t j = i + 1; j < m_vBucketStart[b + 1]; j++ )
+			{
+				const Entry& eB = m_vSorted[j];
+				if ( eA.iX == eB.iX && eA.iY == eB.iY )
+					addPair( eA.uProxy, eB.uProxy, eA.iX, eA.iY );
+			}
+		}
+	}
+
+	// Oversized proxies weren't binned, so check them against every
+	// binned proxy, and against the oversized ones after them
+	for ( size_t o = 0; o < m_vOversized.size(); o++ )
+	{
+		uint32_t uA = m_vOversized[o];
+		for ( uint32_t uB = 0; uB < nProxies; uB++ )
+		{
+			bool bOversizedB = std::binary_search( m_vOversized.begin(), m_vOversized.end(), uB );
+			if ( m_vActive[uB] == false || uB == uA || (bOversizedB && uB < uA) )
+				continue;
+			if ( canPair( uA, uB ) )
+				reportPair( uA, uB );
+		}
+	}
+}
+
+const std::vector<BodyPair>& SpatialHashGrid::GetPairs() const
+{
+	return m_vPairs;
+}
+
+const std::vector<BodyPair>& SpatialHashGrid::GetSoftPairs() const
+{
+	return m_vSoftPairs;
+}
+
+float SpatialHashGrid::GetCellSize() const
+{
+	return m_fCellSize;
+}
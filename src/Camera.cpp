@@ -15,6 +15,7 @@ void Camera::InitOrtho( int nScreenWidth, int nScreenHeight, float xMin, float x
 	m_nScreenWidth = std::max( 0, nScreenWidth );
 	m_nScreenHeight = std::max( 0, nScreenHeight );
 	m_m4Proj = glm::ortho( xMin, xMax, yMin, yMax );
+	m_bCamMatDirty = true;
 }
 
 void Camera::InitPersp( int nScreenWidth, int nScreenHeight, float fovy, float aspect, float near, float far )
@@ -24,6 +25,7 @@ void Camera::InitPersp( int nScreenWidth, int nScreenHeight, float fovy, float a
 	m_nScreenWidth = std::max( 0, nScreenWidth );
 	m_nScreenWidth = std::max( 0, nScreenHeight );
 	m_m4Proj = glm::perspective( fovy, aspect, near, far );
+	m_bCamMatDirty = true;
 }
 
 int Camera::GetScreenWidth() const
@@ -66,21 +68,25 @@ void Camera::Reset()
 void Camera::ResetPos()
 {
 	m_qvTransform.vec = vec3( 0 );
+	m_bCamMatDirty = true;
 }
 
 void Camera::ResetRot()
 {
 	m_qvTransform.quat = fquat( 1, 0, 0, 0 );
+	m_bCamMatDirty = true;
 }
 
 void Camera::ResetTransform()
 {
 	m_qvTransform = quatvec( quatvec::Type::RT );
+	m_bCamMatDirty = true;
 }
 
 void Camera::ResetProj()
 {
 	m_m4Proj = mat4( 1 );
+	m_bCamMatDirty = true;
 }
 
 // Get at the quatvec
@@ -109,23 +115,31 @@ mat4 Camera::GetProjMat() const
 
 mat4 Camera::GetCameraMat() const
 {
-	return GetProjMat() * GetTransformMat();
+	if ( m_bCamMatDirty )
+	{
+		m_m4CameraMat = GetProjMat() * GetTransformMat();
+		m_bCamMatDirty = false;
+	}
+	return m_m4CameraMat;
 }
 
 // These may be wrong, but I have to figure out why
 void Camera::Translate( vec3 t )
 {
 	m_qvTransform.vec += t;
+	m_bCamMatDirty = true;
 }
 
 void Camera::Translate( vec2 t )
 {	
 	m_qvTransform.vec += vec3( t, 0 );
+	m_bCamMatDirty = true;
 }
 
 void Camera::Rotate( fquat q )
 {
 	m_qvTransform.quat *= q;
+	m_bCamMatDirty = true;
 }
 
 /*static*/ void Camera::SetCamMatHandle( GLint h )
@@ -0,0 +1,113 @@
+#include "CollisionBank.h"
+
+#include <utility>
+
+// Slots start out at generation 0, which is never current
+CollisionBank::CollisionBank() :
+	m_vSlots( 64, Slot{ 0, 0, false } ),
+	m_uGen( 1 )
+{}
+
+void CollisionBank::Clear()
+{
+	m_vLive.clear();
+
+	// If the counter wraps, old stamps could look current again
+	if ( ++m_uGen == 0 )
+	{
+		for ( Slot& s : m_vSlots )
+			s.uGen = 0;
+		m_uGen = 1;
+	}
+}
+
+/*static*/ uint64_t CollisionBank::makePair( uint32_t uKeyA, uint32_t uKeyB )
+{
+	if ( uKeyA > uKeyB )
+		std::swap( uKeyA, uKeyB );
+	return ((uint64_t) uKeyA << 32) | uKeyB;
+}
+
+// Linear probing from a multiplicative hash. Returns either the
+// pair's slot or the empty one it would go in (there's always one)
+size_t CollisionBank::findSlot( uint64_t uPair ) const
+{
+	const size_t uMask = m_vSlots.size() - 1;
+	size_t uSlot = (size_t) ((uPair * 0x9E3779B97F4A7C15ull) >> 32) & uMask;
+	while ( m_vSlots[uSlot].uGen == m_uGen && m_vSlots[uSlot].uPair != uPair )
+		uSlot = (uSlot + 1) & uMask;
+	return uSlot;
+}
+
+void CollisionBank::Set( uint32_t uKeyA, uint32_t uKeyB, bool bColliding )
+{
+	// Keep it at most half full
+	if ( 2 * (m_vLive.size() + 1) > m_vSlots.size() )
+		grow();
+
+	const uint64_t uPair = makePair( uKeyA, uKeyB );
+	const size_t uSlot = findSlot( uPair );
+	Slot& s = m_vSlots[uSlot];
+	if ( s.uGen != m_uGen )
+	{
+		s.uPair = uPair;
+		s.uGen = m_uGen;
+		m_vLive.push_back( (uint32_t) uSlot );
+	}
+	s.bColliding = bColliding;
+}
+
+bool CollisionBank::Get( uint32_t uKeyA, uint32_t uKeyB ) const
+{
+	const Slot& s = m_vSlots[findSlot( makePair( uKeyA, uKeyB ) )];
+	return s.uGen == m_uGen && s.bColliding;
+}
+
+size_t CollisionBank::Size() const
+{
+	return m_vLive.size();
+}
+
+// Walks the live slot lists of both tables, so it's linear in
+// the number of pairs rather than the tables' capacity
+void CollisionBank::Diff( const CollisionBank& prev, std::vector<CollisionEvent>& vEvents ) const
+{
+	for ( uint32_t uSlot : m_vLive )
+	{
+		const Slot& s = m_vSlots[uSlot];
+		if ( s.bColliding == false )
+			continue;
+
+		const uint32_t uKeyA = (uint32_t) (s.uPair >> 32), uKeyB = (uint32_t) s.uPair;
+		const bool bWas = prev.Get( uKeyA, uKeyB );
+		vEvents.push_back( { bWas ? CollisionEvent::EType::Persist : CollisionEvent::EType::Begin, uKeyA, uKeyB } );
+	}
+
+	for ( uint32_t uSlot : prev.m_vLive )
+	{
+		const Slot& s = prev.m_vSlots[uSlot];
+		if ( s.bColliding == false )
+			continue;
+
+		const uint32_t uKeyA = (uint32_t) (s.uPair >> 32), uKeyB = (uint32_t) s.uPair;
+		if ( Get( uKeyA, uKeyB ) == false )
+			vEvents.push_back( { CollisionEvent::EType::End, uKeyA, uKeyB } );
+	}
+}
+
+// Double the table and reinsert this generation's pairs
+void CollisionBank::grow()
+{
+	std::vector<Slot> vOld( 2 * m_vSlots.size(), Slot{ 0, 0, false } );
+	vOld.swap( m_vSlots );
+
+	// Only the live slots need moving, and the list gets rebuilt
+	std::vector<uint32_t> vOldLive;
+	vOldLive.swap( m_vLive );
+	for ( uint32_t uOldSlot : vOldLive )
+	{
+		const size_t uSlot = findSlot( vOld[uOldSlot].uPair );
+		m_vSlots[uSlot] = vOld[uOldSlot];
+		m_vLive.push_back( (uint32_t) uSlot );
+	}
+}
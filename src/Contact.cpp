@@ -4,10 +4,12 @@
 #include "GL_Util.h"
 #include "Util.h"
 #include "Drawable.h"
+#include "JobPool.h"
 #include <glm/vec4.hpp>
 #include <glm/gtc/random.hpp>
 
 #include <iostream>
+#include <algorithm>
 
 // Called from constructor, used to get inverse mass
 // (used to calculate inertia when rotation was a thing)
@@ -23,24 +25,20 @@ void Contact::init()
 	if ( m_bHasPlane )
 	{
 		// Plane contacts only have one object with mass
-		fDenom = 1.f / m_pB->fMass;
+		fDenom = m_pB->fInvMass;
 	}
 	else
 	{
-		// Sum denominator
-		for ( RigidBody2D * pRB : { m_pA, m_pB } )
-		{
-			// The inverse mass denominator is a coeffecient used to calculate impulses
-			fDenom += 1.f / pRB->fMass;
-		}
+		// The inverse mass denominator is a coeffecient used to calculate impulses
+		fDenom = m_pA->fInvMass + m_pB->fInvMass;
 	}
 
-	// Is this necessary?
-	if ( fDenom < kEPS )
+	// Immovable bodies have zero inverse mass, two of them can't collide
+	if ( fDenom <= 0.f )
 		throw std::runtime_error( "Error: Invalid inertial denominator calculated!" );
 
-	// Set the inverse mass value
-	m_fInvMass = 1.f / fDenom;
+	// Set the effective mass, the solver multiplies by this every iteration
+	m_fEffMass = 1.f / fDenom;
 }
 
 // Default ctor
@@ -53,7 +51,8 @@ Contact::Contact() :
 	m_v2Normal( vec2() ),
 	m_fDist( 0 ),
 	m_fCurImpulse( 0 ),
-	m_fInvMass(0)
+	m_fEffMass( 0 ),
+	m_uCacheKey( 0 )
 {}
 
 // RB-RB contact ctor
@@ -65,7 +64,8 @@ Contact::Contact( RigidBody2D * pA, RigidBody2D * pB, const vec2 posA, const vec
 	m_v2Pos{ posA, posB },
 	m_v2Normal( nrm ),
 	m_fDist( d ),
-	m_fCurImpulse( 0 )
+	m_fCurImpulse( 0 ),
+	m_uCacheKey( 0 )
 {
 	init();
 }
@@ -79,7 +79,8 @@ Contact::Contact( Plane * pPlaneA, RigidBody2D * pB, const vec2 posA, const vec2
 	m_v2Pos{ posA, posB },
 	m_v2Normal( nrm ),
 	m_fDist( d ),
-	m_fCurImpulse( 0 )
+	m_fCurImpulse( 0 ),
+	m_uCacheKey( 0 )
 {
 	init();
 }
@@ -95,14 +96,14 @@ void Contact::ApplyImpulse( float fMag )
 	vec2 v2Impulse = delImpulse * m_v2Normal;
 
 	// If no plane and A is not immovable, jostle A
-	if ( m_bHasPlane == false && m_pA->fMass > 0 )
+	if ( m_bHasPlane == false && m_pA->fInvMass > 0 )
 	{
-		m_pA->v2Vel += v2Impulse / m_pA->fMass;
+		m_pA->v2Vel += v2Impulse * m_pA->fInvMass;
 	}
 
 	// Jostle B
-	if ( m_pB->fMass > 0 )
-		m_pB->v2Vel -= v2Impulse / m_pB->fMass;
+	if ( m_pB->fInvMass > 0 )
+		m_pB->v2Vel -= v2Impulse * m_pB->fInvMass;
 
 	// Add impulse to member var
 	m_fCurImpulse = newImpulse;
@@ -128,9 +129,9 @@ float Contact::GetAvgCoefRest() const
 		return .5f * (m_pA->fElast + m_pB->fElast);
 }
 
-float Contact::GetInvMass() const
+float Contact::GetEffectiveMass() const
 {
-	return m_fInvMass;
+	return m_fEffMass;
 }
 
 float Contact::GetRelVel() const
@@ -172,6 +173,16 @@ const RigidBody2D * Contact::GetBodyB() const
 	return m_pB;
 }
 
+void Contact::SetCacheKey( uint64_t uKey )
+{
+	m_uCacheKey = uKey;
+}
+
+uint64_t Contact::GetCacheKey() const
+{
+	return m_uCacheKey;
+}
+
 bool Contact::IsColliding() const
 {
 	return m_bIsColliding;
@@ -184,17 +195,69 @@ void Contact::setIsColliding( bool bColliding )
 
 // Contact Solver
 Contact::Solver::Solver():
-	m_nIterations(1)
+	m_nIterations( 1 ),
+	m_fInvTimeStep( g_fInvTimeStep ),
+	m_nLastIterations( 0 )
 {}
 
 Contact::Solver::Solver( uint32_t nIterations ) :
-	m_nIterations( nIterations )
+	m_nIterations( nIterations ),
+	m_fInvTimeStep( g_fInvTimeStep ),
+	m_nLastIterations( 0 )
 {}
 
-uint32_t Contact::Solver::Solve( std::list<Contact>& liContacts )
+void Contact::Solver::SetTimeStep( float fDT )
+{
+	m_fInvTimeStep = 1.f / fDT;
+}
+
+void Contact::Solver::SetIterations( uint32_t nIterations )
+{
+	m_nIterations = std::max( 1u, nIterations );
+}
+
+uint32_t Contact::Solver::GetIterations() const
+{
+	return m_nIterations;
+}
+
+uint32_t Contact::Solver::GetLastIterations() const
+{
+	return m_nLastIterations;
+}
+
+// One Gauss-Seidel visit to a contact, returns true if it applied an impulse
+bool Contact::Solver::solveContact( Contact& c ) const
+{
+	// Coeffcicient of restitution, plus 1
+	const float fCr_1 = 1.f + c.GetAvgCoefRest();
+
+	// Get the relative velocity of each body along the contact normal
+	float fRelVN = c.GetRelVel();
+
+	// Determine how much velocity we'd need to remove such that
+	// in the next iteration the two objects will be touching
+	float fVelNeeded = c.GetDistance() * m_fInvTimeStep;
+	float fVelToRemove = fRelVN + fVelNeeded;
+
+	// If this is very low
+	if ( fVelToRemove < kEPS )
+	{
+		// apply a collison along the normal
+		c.ApplyImpulse( fCr_1 * fRelVN * c.GetEffectiveMass() );
+		// flag contact as colliding
+		c.setIsColliding( true );
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t Contact::Solver::Solve( Span<Contact> spContacts )
 {
 	// Return the # of collisions
 	uint32_t uNumCollisions( 0 );
+	m_nLastIterations = 0;
 
 	// Iterate and solve contacts
 	for ( uint32_t nIt = 0; nIt < m_nIterations; nIt++ )
@@ -203,41 +266,70 @@ uint32_t Contact::Solver::Solve( std::list<Contact>& liContacts )
 		uint32_t uColCount = 0;
 
 		// Walk the contacts
-		for ( Contact& c : liContacts )
-		{
-			// Coeffcicient of restitution, plus 1
-			const float fCr_1 = 1.f + c.GetAvgCoefRest();
-
-			// Get the relative velocity of each body along the contact normal
-			float fRelVN = c.GetRelVel();
-
-			// Determine how much velocity we'd need to remove such that
-			// in the next iteration the two objects will be touching
-			float fVelNeeded = c.GetDistance() * g_fInvTimeStep;
-			float fVelToRemove = fRelVN + fVelNeeded;
-
-			// If this is very low
-			if ( fVelToRemove < kEPS )
-			{
-				// apply a collison along the normal
-				c.ApplyImpulse( fCr_1 * fRelVN * c.GetInvMass() );
-				// Increase collision counter, flag contact as colliding
+		for ( Contact& c : spContacts )
+			if ( solveContact( c ) )
 				uColCount++;
-				c.setIsColliding( true );
-			}
-		}
 
 		// Maybe break if no contacts are colliding
 		if ( uColCount == 0 )
 			break;
 		// Otherwise keep going
 		else
+		{
 			uNumCollisions += uColCount;
+			m_nLastIterations++;
+		}
 	}
 
 	return uNumCollisions;
 }
 
+// Islands share no movable bodies, so each one can run the same loop
+// on its own thread. Contacts keep their relative order within an island
+// and an island that stops colliding would have been left alone by
+// the serial loop anyway, so this gives exactly what Solve would
+uint32_t Contact::Solver::SolveIslands( Span<Contact> spContacts, Span<const uint32_t> spOrder, Span<const uint32_t> spIslandStart, JobPool& jobPool )
+{
+	const size_t nIslands = spIslandStart.empty() ? 0 : spIslandStart.size() - 1;
+	m_vIslandIterations.assign( nIslands, 0 );
+	m_vIslandCollisions.assign( nIslands, 0 );
+
+	jobPool.Run( nIslands, [&] ( size_t uIsland )
+	{
+		uint32_t& nIterations = m_vIslandIterations[uIsland];
+		uint32_t& uNumCollisions = m_vIslandCollisions[uIsland];
+		for ( uint32_t nIt = 0; nIt < m_nIterations; nIt++ )
+		{
+			uint32_t uColCount = 0;
+			for ( uint32_t i = spIslandStart[uIsland]; i < spIslandStart[uIsland + 1]; i++ )
+				if ( solveContact( spContacts[spOrder[i]] ) )
+					uColCount++;
+
+			if ( uColCount == 0 )
+				break;
+
+			uNumCollisions += uColCount;
+			nIterations++;
+		}
+	} );
+
+	// Sum up in island order
+	uint32_t uNumCollisions( 0 );
+	m_nLastIterations = 0;
+	for ( size_t i = 0; i < nIslands; i++ )
+	{
+		uNumCollisions += m_vIslandCollisions[i];
+		m_nLastIterations = std::max( m_nLastIterations, m_vIslandIterations[i] );
+	}
+
+	return uNumCollisions;
+}
+
+const std::vector<uint32_t>& Contact::Solver::GetIslandIterations() const
+{
+	return m_vIslandIterations;
+}
+
 // Used for debugging
 void Contact::InitDrawable( std::array<Drawable *, 2> drPtrArr ) const
 {
@@ -0,0 +1,60 @@
+#include "ContactCache.h"
+
+#include <algorithm>
+
+ContactCache::ContactCache() :
+	m_uNumWarmStarted( 0 )
+{}
+
+/*static*/ uint64_t ContactCache::MakePairKey( uint32_t uBodyA, uint32_t uBodyB )
+{
+	return ((uint64_t) uBodyA << 32) | uBodyB;
+}
+
+// Plane keys get the top bit so they can't collide with pair keys
+/*static*/ uint64_t ContactCache::MakePlaneKey( uint32_t uPlane, uint32_t uBody )
+{
+	return (1ull << 63) | ((uint64_t) uPlane << 32) | uBody;
+}
+
+void ContactCache::WarmStart( Span<Contact> spContacts, float fFactor, float fInvDT )
+{
+	m_uNumWarmStarted = 0;
+	if ( fFactor <= 0.f || m_vEntries.empty() )
+		return;
+
+	for ( Contact& c : spContacts )
+	{
+		auto it = std::lower_bound( m_vEntries.begin(), m_vEntries.end(), Entry( c.GetCacheKey(), 0.f ),
+									[] ( const Entry& a, const Entry& b ) { return a.first < b.first; } );
+		if ( it == m_vEntries.end() || it->first != c.GetCacheKey() )
+			continue;
+
+		// Only warm start if the pair is closing in, and don't apply
+		// more than it takes to get them just touching (the solver
+		// is still responsible for restitution)
+		float fVelToRemove = c.GetRelVel() + c.GetDistance() * fInvDT;
+		if ( fVelToRemove >= 0.f )
+			continue;
+
+		float fImpulse = std::max( fFactor * it->second, fVelToRemove * c.GetEffectiveMass() );
+		c.ApplyImpulse( fImpulse );
+		m_uNumWarmStarted++;
+	}
+}
+
+void ContactCache::Store( Span<const Contact> spContacts )
+{
+	m_vEntries.clear();
+	for ( const Contact& c : spContacts )
+		if ( c.GetCurImpulse() < 0.f )
+			m_vEntries.emplace_back( c.GetCacheKey(), c.GetCurImpulse() );
+
+	std::sort( m_vEntries.begin(), m_vEntries.end(),
+			   [] ( const Entry& a, const Entry& b ) { return a.first < b.first; } );
+}
+
+uint32_t ContactCache::GetNumWarmStarted() const
+{
+	return m_uNumWarmStarted;
+}
@@ -0,0 +1,330 @@
+#include "ContactKernels.h"
+#include "RigidBodyStore.h"
+#include "RigidBody2D.h"
+#include "Contact.h"
+#include "Plane.h"
+#include "GL_Util.h"
+
+#include <cmath>
+#include <algorithm>
+
+// SRB_NO_SIMD forces the scalar loop, so it can be checked against the others
+#if defined( SRB_NO_SIMD )
+#elif defined( __AVX__ )
+#define SRB_AVX
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define SRB_SSE
+#include <xmmintrin.h>
+#endif
+
+// Pairs get gathered into blocks this big, which is a full AVX
+// register (or two SSE ones). The math is done on the block with
+// plain sqrt / div, so every path gives the same bits
+static const size_t kBlock = 8;
+
+// Everything a circle pair contact needs
+struct CircleBlock
+{
+	float aAX[kBlock], aAY[kBlock], aRA[kBlock];
+	float aBX[kBlock], aBY[kBlock], aRB[kBlock];
+	float aNX[kBlock], aNY[kBlock], aDist[kBlock];
+};
+
+static void circleMath( CircleBlock& b, size_t i )
+{
+	float dX = b.aBX[i] - b.aAX[i];
+	float dY = b.aBY[i] - b.aAY[i];
+	float fLen = std::sqrt( dX * dX + dY * dY );
+	float fInvLen = 1.f / fLen;
+	b.aNX[i] = dX * fInvLen;
+	b.aNY[i] = dY * fInvLen;
+	b.aDist[i] = fLen - b.aRA[i] - b.aRB[i];
+}
+
+// The distance between the circumferences is the center distance minus
+// both radii, which is negative when they overlap. That's what the scalar
+// version gets by measuring between contact points and flipping the sign
+static void circleMath( CircleBlock& b )
+{
+	size_t i = 0;
+#if defined( SRB_AVX )
+	__m256 vDX = _mm256_sub_ps( _mm256_loadu_ps( b.aBX ), _mm256_loadu_ps( b.aAX ) );
+	__m256 vDY = _mm256_sub_ps( _mm256_loadu_ps( b.aBY ), _mm256_loadu_ps( b.aAY ) );
+	__m256 vLen = _mm256_sqrt_ps( _mm256_add_ps( _mm256_mul_ps( vDX, vDX ), _mm256_mul_ps( vDY, vDY ) ) );
+	__m256 vInvLen = _mm256_div_ps( _mm256_set1_ps( 1.f ), vLen );
+	_mm256_storeu_ps( b.aNX, _mm256_mul_ps( vDX, vInvLen ) );
+	_mm256_storeu_ps( b.aNY, _mm256_mul_ps( vDY, vInvLen ) );
+	_mm256_storeu_ps( b.aDist, _mm256_sub_ps( _mm256_sub_ps( vLen, _mm256_loadu_ps( b.aRA ) ), _mm256_loadu_ps( b.aRB ) ) );
+	i = 8;
+#elif defined( SRB_SSE )
+	for ( ; i + 4 <= kBlock; i += 4 )
+	{
+		__m128 vDX = _mm_sub_ps( _mm_loadu_ps( b.aBX + i ), _mm_loadu_ps( b.aAX + i ) );
+		__m128 vDY = _mm_sub_ps( _mm_loadu_ps( b.aBY + i ), _mm_loadu_ps( b.aAY + i ) );
+		__m128 vLen = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( vDX, vDX ), _mm_mul_ps( vDY, vDY ) ) );
+		__m128 vInvLen = _mm_div_ps( _mm_set1_ps( 1.f ), vLen );
+		_mm_storeu_ps( b.aNX + i, _mm_mul_ps( vDX, vInvLen ) );
+		_mm_storeu_ps( b.aNY + i, _mm_mul_ps( vDY, vInvLen ) );
+		_mm_storeu_ps( b.aDist + i, _mm_sub_ps( _mm_sub_ps( vLen, _mm_loadu_ps( b.aRA + i ) ), _mm_loadu_ps( b.aRB + i ) ) );
+	}
+#endif
+	for ( ; i < kBlock; i++ )
+		circleMath( b, i );
+}
+
+void GetCircleContacts( const RigidBodyStore& store, RigidBody2D * pBodies, Span<const BodyPair> spPairs, Contact * pOut )
+{
+	const float * pPX = store.PosX(), * pPY = store.PosY(), * pR = store.ExtX();
+
+	CircleBlock b;
+	for ( size_t uStart = 0; uStart < spPairs.size(); uStart += kBlock )
+	{
+		const size_t nInBlock = std::min( kBlock, spPairs.size() - uStart );
+
+		// Gather
+		for ( size_t i = 0; i < nInBlock; i++ )
+		{
+			const BodyPair& bp = spPairs[uStart + i];
+			b.aAX[i] = pPX[bp.first];	b.aAY[i] = pPY[bp.first];	b.aRA[i] = pR[bp.first];
+			b.aBX[i] = pPX[bp.second];	b.aBY[i] = pPY[bp.second];	b.aRB[i] = pR[bp.second];
+		}
+
+		// A partial block is the tail, just do it one at a time
+		if ( nInBlock == kBlock )
+			circleMath( b );
+		else
+			for ( size_t i = 0; i < nInBlock; i++ )
+				circleMath( b, i );
+
+		// Emit
+		for ( size_t i = 0; i < nInBlock; i++ )
+		{
+			const BodyPair& bp = spPairs[uStart + i];
+			vec2 n( b.aNX[i], b.aNY[i] );
+			vec2 a_pos = vec2( b.aAX[i], b.aAY[i] ) + n * b.aRA[i];
+			vec2 b_pos = vec2( b.aBX[i], b.aBY[i] ) - n * b.aRB[i];
+			pOut[uStart + i] = Contact( &pBodies[bp.first], &pBodies[bp.second], a_pos, b_pos, n, b.aDist[i] );
+		}
+	}
+}
+
+// Everything a box pair contact needs. M is which axes
+// the contact points get pushed along, S is their sign
+struct BoxBlock
+{
+	float aAX[kBlock], aAY[kBlock], aHAX[kBlock], aHAY[kBlock];
+	float aBX[kBlock], aBY[kBlock], aHBX[kBlock], aHBY[kBlock];
+	float aSX[kBlock], aSY[kBlock], aMX[kBlock], aMY[kBlock];
+	float aNX[kBlock], aNY[kBlock], aDist[kBlock];
+};
+
+// Lane i of the box math, written as selects like GetSpecContact
+static void boxMath( BoxBlock& b, size_t i )
+{
+	float dX = b.aBX[i] - b.aAX[i];
+	float dY = b.aBY[i] - b.aAY[i];
+	float sX = dX < 0 ? -1.f : 1.f;
+	float sY = dY < 0 ? -1.f : 1.f;
+	float gX = std::fabs( dX ) - (b.aHAX[i] + b.aHBX[i]);
+	float gY = std::fabs( dY ) - (b.aHAY[i] + b.aHBY[i]);
+
+	bool bCorner = gX > 0 && gY > 0;
+	bool bUseX = gX > gY;
+	float mX = bCorner || bUseX ? 1.f : 0.f;
+	float mY = bCorner || bUseX == false ? 1.f : 0.f;
+
+	float aX = bCorner ? gX : mX;
+	float aY = bCorner ? gY : mY;
+	float fLen = std::sqrt( aX * aX + aY * aY );
+	float fInvLen = 1.f / fLen;
+	b.aNX[i] = (sX * aX) * fInvLen;
+	b.aNY[i] = (sY * aY) * fInvLen;
+	b.aDist[i] = bCorner ? fLen : (bUseX ? gX : gY);
+	b.aSX[i] = sX;	b.aSY[i] = sY;
+	b.aMX[i] = mX;	b.aMY[i] = mY;
+}
+
+#if defined( SRB_AVX )
+static inline __m256 sel( __m256 vMask, __m256 vT, __m256 vF )
+{
+	return _mm256_blendv_ps( vF, vT, vMask );
+}
+#elif defined( SRB_SSE )
+static inline __m128 sel( __m128 vMask, __m128 vT, __m128 vF )
+{
+	return _mm_or_ps( _mm_and_ps( vMask, vT ), _mm_andnot_ps( vMask, vF ) );
+}
+#endif
+
+static void boxMath( BoxBlock& b )
+{
+	size_t i = 0;
+#if defined( SRB_AVX )
+	const __m256 vZero = _mm256_setzero_ps();
+	const __m256 vOne = _mm256_set1_ps( 1.f );
+	const __m256 vSign = _mm256_set1_ps( -0.f );
+
+	__m256 vDX = _mm256_sub_ps( _mm256_loadu_ps( b.aBX ), _mm256_loadu_ps( b.aAX ) );
+	__m256 vDY = _mm256_sub_ps( _mm256_loadu_ps( b.aBY ), _mm256_loadu_ps( b.aAY ) );
+	__m256 vSX = sel( _mm256_cmp_ps( vDX, vZero, _CMP_LT_OQ ), _mm256_set1_ps( -1.f ), vOne );
+	__m256 vSY = sel( _mm256_cmp_ps( vDY, vZero, _CMP_LT_OQ ), _mm256_set1_ps( -1.f ), vOne );
+	__m256 vGX = _mm256_sub_ps( _mm256_andnot_ps( vSign, vDX ), _mm256_add_ps( _mm256_loadu_ps( b.aHAX ), _mm256_loadu_ps( b.aHBX ) ) );
+	__m256 vGY = _mm256_sub_ps( _mm256_andnot_ps( vSign, vDY ), _mm256_add_ps( _mm256_loadu_ps( b.aHAY ), _mm256_loadu_ps( b.aHBY ) ) );
+
+	__m256 vCorner = _mm256_and_ps( _mm256_cmp_ps( vGX, vZero, _CMP_GT_OQ ), _mm256_cmp_ps( vGY, vZero, _CMP_GT_OQ ) );
+	__m256 vUseX = _mm256_cmp_ps( vGX, vGY, _CMP_GT_OQ );
+	__m256 vMX = _mm256_and_ps( _mm256_or_ps( vCorner, vUseX ), vOne );
+	__m256 vMY = _mm256_and_ps( _mm256_or_ps( vCorner, _mm256_xor_ps( vUseX, _mm256_cmp_ps( vZero, vZero, _CMP_EQ_OQ ) ) ), vOne );
+
+	__m256 vAX = sel( vCorner, vGX, vMX );
+	__m256 vAY = sel( vCorner, vGY, vMY );
+	__m256 vLen = _mm256_sqrt_ps( _mm256_add_ps( _mm256_mul_ps( vAX, vAX ), _mm256_mul_ps( vAY, vAY ) ) );
+	__m256 vInvLen = _mm256_div_ps( vOne, vLen );
+	_mm256_storeu_ps( b.aNX, _mm256_mul_ps( _mm256_mul_ps( vSX, vAX ), vInvLen ) );
+	_mm256_storeu_ps( b.aNY, _mm256_mul_ps( _mm256_mul_ps( vSY, vAY ), vInvLen ) );
+	_mm256_storeu_ps( b.aDist, sel( vCorner, vLen, sel( vUseX, vGX, vGY ) ) );
+	_mm256_storeu_ps( b.aSX, vSX );	_mm256_storeu_ps( b.aSY, vSY );
+	_mm256_storeu_ps( b.aMX, vMX );	_mm256_storeu_ps( b.aMY, vMY );
+	i = 8;
+#elif defined( SRB_SSE )
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vOne = _mm_set1_ps( 1.f );
+	const __m128 vSign = _mm_set1_ps( -0.f );
+	for ( ; i + 4 <= kBlock; i += 4 )
+	{
+		__m128 vDX = _mm_sub_ps( _mm_loadu_ps( b.aBX + i ), _mm_loadu_ps( b.aAX + i ) );
+		__m128 vDY = _mm_sub_ps( _mm_loadu_ps( b.aBY + i ), _mm_loadu_ps( b.aAY + i ) );
+		__m128 vSX = sel( _mm_cmplt_ps( vDX, vZero ), _mm_set1_ps( -1.f ), vOne );
+		__m128 vSY = sel( _mm_cmplt_ps( vDY, vZero ), _mm_set1_ps( -1.f ), vOne );
+		__m128 vGX = _mm_sub_ps( _mm_andnot_ps( vSign, vDX ), _mm_add_ps( _mm_loadu_ps( b.aHAX + i ), _mm_loadu_ps( b.aHBX + i ) ) );
+		__m128 vGY = _mm_sub_ps( _mm_andnot_ps( vSign, vDY ), _mm_add_ps( _mm_loadu_ps( b.aHAY + i ), _mm_loadu_ps( b.aHBY + i ) ) );
+
+		__m128 vCorner = _mm_and_ps( _mm_cmpgt_ps( vGX, vZero ), _mm_cmpgt_ps( vGY, vZero ) );
+		__m128 vUseX = _mm_cmpgt_ps( vGX, vGY );
+		__m128 vMX = _mm_and_ps( _mm_or_ps( vCorner, vUseX ), vOne );
+		__m128 vMY = _mm_and_ps( _mm_or_ps( vCorner, _mm_xor_ps( vUseX, _mm_cmpeq_ps( vZero, vZero ) ) ), vOne );
+
+		__m128 vAX = sel( vCorner, vGX, vMX );
+		__m128 vAY = sel( vCorner, vGY, vMY );
+		__m128 vLen = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( vAX, vAX ), _mm_mul_ps( vAY, vAY ) ) );
+		__m128 vInvLen = _mm_div_ps( vOne, vLen );
+		_mm_storeu_ps( b.aNX + i, _mm_mul_ps( _mm_mul_ps( vSX, vAX ), vInvLen ) );
+		_mm_storeu_ps( b.aNY + i, _mm_mul_ps( _mm_mul_ps( vSY, vAY ), vInvLen ) );
+		_mm_storeu_ps( b.aDist + i, sel( vCorner, vLen, sel( vUseX, vGX, vGY ) ) );
+		_mm_storeu_ps( b.aSX + i, vSX );	_mm_storeu_ps( b.aSY + i, vSY );
+		_mm_storeu_ps( b.aMX + i, vMX );	_mm_storeu_ps( b.aMY + i, vMY );
+	}
+#endif
+	for ( ; i < kBlock; i++ )
+		boxMath( b, i );
+}
+
+void GetBoxContacts( const RigidBodyStore& store, RigidBody2D * pBodies, Span<const BodyPair> spPairs, Contact * pOut )
+{
+	const float * pPX = store.PosX(), * pPY = store.PosY();
+	const float * pHX = store.ExtX(), * pHY = store.ExtY();
+
+	BoxBlock b;
+	for ( size_t uStart = 0; uStart < spPairs.size(); uStart += kBlock )
+	{
+		const size_t nInBlock = std::min( kBlock, spPairs.size() - uStart );
+
+		// Gather
+		for ( size_t i = 0; i < nInBlock; i++ )
+		{
+			const BodyPair& bp = spPairs[uStart + i];
+			b.aAX[i] = pPX[bp.first];	b.aAY[i] = pPY[bp.first];
+			b.aHAX[i] = pHX[bp.first];	b.aHAY[i] = pHY[bp.first];
+			b.aBX[i] = pPX[bp.second];	b.aBY[i] = pPY[bp.second];
+			b.aHBX[i] = pHX[bp.second];	b.aHBY[i] = pHY[bp.second];
+		}
+
+		if ( nInBlock == kBlock )
+			boxMath( b );
+		else
+			for ( size_t i = 0; i < nInBlock; i++ )
+				boxMath( b, i );
+
+		// Emit, pushing the centers out to the faces / corners
+		for ( size_t i = 0; i < nInBlock; i++ )
+		{
+			const BodyPair& bp = spPairs[uStart + i];
+			vec2 n( b.aNX[i], b.aNY[i] );
+			vec2 sm = vec2( b.aSX[i], b.aSY[i] ) * vec2( b.aMX[i], b.aMY[i] );
+			vec2 a_pos = vec2( b.aAX[i], b.aAY[i] ) + sm * vec2( b.aHAX[i], b.aHAY[i] );
+			vec2 b_pos = vec2( b.aBX[i], b.aBY[i] ) - sm * vec2( b.aHBX[i], b.aHBY[i] );
+			pOut[uStart + i] = Contact( &pBodies[bp.first], &pBodies[bp.second], a_pos, b_pos, n, b.aDist[i] );
+		}
+	}
+}
+
+// The distance used is from the plane to the body's support point, the
+// center less its extent along the normal. Circles use their radius for
+// both extents, so that's only exact for them on axis aligned planes, but
+// it's never more than the real distance (or the one the contact gets).
+// Bodies are done several at a time, planes one after another
+size_t GetPlaneCandidates( const RigidBodyStore& store, const Plane& plane, float fDT, float fMargin, uint32_t * pOut )
+{
+	const size_t N = store.Size();
+	const float * pPX = store.PosX(), * pPY = store.PosY();
+	const float * pVX = store.VelX(), * pVY = store.VelY();
+	const float * pEX = store.ExtX(), * pEY = store.ExtY();
+	const float * pIM = store.InvMass(), * pA = store.Active();
+	const float fNX = plane.v2Normal.x, fNY = plane.v2Normal.y;
+	const float fAbsNX = std::fabs( fNX ), fAbsNY = std::fabs( fNY );
+
+	size_t nOut = 0, i = 0;
+#if defined( SRB_AVX )
+	const __m256 vNX = _mm256_set1_ps( fNX ), vNY = _mm256_set1_ps( fNY );
+	const __m256 vAbsNX = _mm256_set1_ps( fAbsNX ), vAbsNY = _mm256_set1_ps( fAbsNY );
+	const __m256 vPlaneDist = _mm256_set1_ps( plane.fDist );
+	const __m256 vDT = _mm256_set1_ps( fDT ), vMargin = _mm256_set1_ps( fMargin );
+	const __m256 vZero = _mm256_setzero_ps();
+	for ( ; i + 8 <= N; i += 8 )
+	{
+		__m256 vCen = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( pPX + i ), vNX ), _mm256_mul_ps( _mm256_loadu_ps( pPY + i ), vNY ) );
+		__m256 vExt = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( pEX + i ), vAbsNX ), _mm256_mul_ps( _mm256_loadu_ps( pEY + i ), vAbsNY ) );
+		__m256 vVel = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( pVX + i ), vNX ), _mm256_mul_ps( _mm256_loadu_ps( pVY + i ), vNY ) );
+		__m256 vSpec = _mm256_add_ps( _mm256_sub_ps( _mm256_sub_ps( vCen, vPlaneDist ), vExt ), _mm256_mul_ps( vVel, vDT ) );
+		__m256 vKeep = _mm256_and_ps( _mm256_cmp_ps( vSpec, vMargin, _CMP_LE_OQ ),
+									  _mm256_and_ps( _mm256_cmp_ps( _mm256_loadu_ps( pA + i ), vZero, _CMP_GT_OQ ),
+													 _mm256_cmp_ps( _mm256_loadu_ps( pIM + i ), vZero, _CMP_GT_OQ ) ) );
+		int nMask = _mm256_movemask_ps( vKeep );
+		for ( int j = 0; j < 8; j++ )
+			if ( nMask & (1 << j) )
+				pOut[nOut++] = (uint32_t) (i + j);
+	}
+#elif defined( SRB_SSE )
+	const __m128 vNX = _mm_set1_ps( fNX ), vNY = _mm_set1_ps( fNY );
+	const __m128 vAbsNX = _mm_set1_ps( fAbsNX ), vAbsNY = _mm_set1_ps( fAbsNY );
+	const __m128 vPlaneDist = _mm_set1_ps( plane.fDist );
+	const __m128 vDT = _mm_set1_ps( fDT ), vMargin = _mm_set1_ps( fMargin );
+	const __m128 vZero = _mm_setzero_ps();
+	for ( ; i + 4 <= N; i += 4 )
+	{
+		__m128 vCen = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pPX + i ), vNX ), _mm_mul_ps( _mm_loadu_ps( pPY + i ), vNY ) );
+		__m128 vExt = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pEX + i ), vAbsNX ), _mm_mul_ps( _mm_loadu_ps( pEY + i ), vAbsNY ) );
+		__m128 vVel = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pVX + i ), vNX ), _mm_mul_ps( _mm_loadu_ps( pVY + i ), vNY ) );
+		__m128 vSpec = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( vCen, vPlaneDist ), vExt ), _mm_mul_ps( vVel, vDT ) );
+		__m128 vKeep = _mm_and_ps( _mm_cmple_ps( vSpec, vMargin ),
+								   _mm_and_ps( _mm_cmpgt_ps( _mm_loadu_ps( pA + i ), vZero ),
+											   _mm_cmpgt_ps( _mm_loadu_ps( pIM + i ), vZero ) ) );
+		int nMask = _mm_movemask_ps( vKeep );
+		for ( int j = 0; j < 4; j++ )
+			if ( nMask & (1 << j) )
+				pOut[nOut++] = (uint32_t) (i + j);
+	}
+#endif
+	for ( ; i < N; i++ )
+	{
+		float fCen = pPX[i] * fNX + pPY[i] * fNY;
+		float fExt = pEX[i] * fAbsNX + pEY[i] * fAbsNY;
+		float fVel = pVX[i] * fNX + pVY[i] * fNY;
+		float fSpec = fCen - plane.fDist - fExt + fVel * fDT;
+		if ( fSpec <= fMargin && pA[i] > 0 && pIM[i] > 0 )
+			pOut[nOut++] = (uint32_t) i;
+	}
+
+	return nOut;
+}
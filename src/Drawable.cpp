@@ -16,7 +16,8 @@ Drawable::Drawable() :
 	m_nIdx( 0 ),
 	m_v2Scale( 1 ),
 	m_v4Color( 1 ),
-	m_qvTransform( quatvec::Type::TRT )
+	m_qvTransform( quatvec::Type::TRT ),
+	m_bMVDirty( true )
 {}
 
 // Function for getting data into a Vertex Buffer Object
@@ -92,6 +93,7 @@ bool Drawable::Init( std::string strName, std::array<glm::vec3, 3> triVerts, glm
 	m_v2Scale = v2Scale;
 	m_v4Color = v4Color;
 	m_bActive = true;
+	m_bMVDirty = true;
 
 	// Store the values from the static cache, return true
 	m_VAO = s_VAOCache[strName][0];
@@ -179,6 +181,7 @@ bool Drawable::Init( std::string strIqmSrcFile, glm::vec4 v4Color, quatvec qvTra
 	m_v2Scale = v2Scale;
 	m_v4Color = v4Color;
 	m_bActive = true;
+	m_bMVDirty = true;
 
 	// Store the values from the static cache, return true
 	m_VAO = s_VAOCache[strIqmSrcFile][0];
@@ -207,64 +210,113 @@ quatvec Drawable::GetTransform() const
 	return m_qvTransform;
 }
 
+// Most drawables are TR and only rotate about z, so their MV is a 2D
+// affine transform we can write out directly. It matches what the
+// general path gives, which costs a quat -> mat4 and two products
+void Drawable::updateMV() const
+{
+	const fquat& q = m_qvTransform.quat;
+	if ( m_qvTransform.eType == quatvec::Type::TR && q.x == 0 && q.y == 0 )
+	{
+		const float c = 1.f - 2.f * q.z * q.z;
+		const float s = 2.f * q.w * q.z;
+		m_m4MV = mat4( c * m_v2Scale.x, s * m_v2Scale.x, 0, 0,
+					   -s * m_v2Scale.y, c * m_v2Scale.y, 0, 0,
+					   0, 0, 1, 0,
+					   m_qvTransform.vec.x, m_qvTransform.vec.y, m_qvTransform.vec.z, 1 );
+	}
+	else
+		m_m4MV = m_qvTransform.ToMat4() * glm::scale( vec3( m_v2Scale, 1.f ) );
+
+	m_bMVDirty = false;
+}
+
 mat4 Drawable::GetMV() const
 {
-	return m_qvTransform.ToMat4() * glm::scale( vec3( m_v2Scale, 1.f ) );
+	if ( m_bMVDirty )
+		updateMV();
+	return m_m4MV;
+}
+
+mat4 Drawable::GetMV( vec2 v2Pos ) const
+{
+	// For TR the translation is applied last, so it's just the last column
+	if ( m_qvTransform.eType == quatvec::Type::TR )
+	{
+		mat4 MV = GetMV();
+		MV[3] = vec4( v2Pos, m_qvTransform.vec.z, 1 );
+		return MV;
+	}
+
+	quatvec qvTransform = m_qvTransform;
+	qvTransform.vec = vec3( v2Pos, m_qvTransform.vec.z );
+	return qvTransform.ToMat4() * glm::scale( vec3( m_v2Scale, 1.f ) );
 }
 
 void Drawable::SetPos3D( vec3 t )
 {
 	m_qvTransform.vec = t;
+	m_bMVDirty = true;
 }
 
 void Drawable::Translate3D( vec3 t )
 {
 	m_qvTransform.vec += t;
+	m_bMVDirty = true;
 }
 
 void Drawable::SetPos2D( vec2 t )
 {
 	m_qvTransform.vec = vec3( t, 0 );
+	m_bMVDirty = true;
 }
 
 void Drawable::Translate2D( vec2 t )
 {
 	m_qvTransform.vec += vec3( t, 0 );
+	m_bMVDirty = true;
 }
 
 void Drawable::SetRot( fquat q )
 {
 	m_qvTransform.quat = q;
+	m_bMVDirty = true;
 }
 
 void Drawable::Rotate( fquat q )
 {
 	m_qvTransform.quat *= q;
+	m_bMVDirty = true;
 }
 
 void Drawable::SetTransform( quatvec qv )
 {
 	m_qvTransform = qv;
+	m_bMVDirty = true;
 }
 
 void Drawable::Transform( quatvec qv )
 {
 	m_qvTransform *= qv;
+	m_bMVDirty = true;
 }
 
 void Drawable::Scale( vec2 s )
 {
 	m_v2Scale *= s;
+	m_bMVDirty = true;
 }
 
 void Drawable::Scale( float s )
 {
 	m_v2Scale *= s;
+	m_bMVDirty = true;
 }
 
 void Drawable::SetScale( vec2 s )
 {
 	m_v2Scale = s;
+	m_bMVDirty = true;
 }
 
 void Drawable::SetColor( vec4 c )
@@ -291,6 +343,31 @@ bool Drawable::Draw()
 	return true;
 }
 
+// Same as Draw, but once per instance in whatever
+// instance buffer is bound to the VAO's instance attributes
+bool Drawable::DrawInstanced( GLsizei nInstances ) const
+{
+	if ( s_PosHandle < 0 )
+	{
+		std::cerr << "Error! Static drawable handles not set!" << std::endl;
+		return false;
+	}
+
+	// Core in 3.1, ARB_instanced_arrays has its own before that
+	glBindVertexArray( m_VAO );
+	if ( GLEW_VERSION_3_1 )
+		glDrawElementsInstanced( GL_TRIANGLES, m_nIdx, GL_UNSIGNED_INT, NULL, nInstances );
+	else
+		glDrawElementsInstancedARB( GL_TRIANGLES, m_nIdx, GL_UNSIGNED_INT, NULL, nInstances );
+
+	return true;
+}
+
+GLuint Drawable::GetVAO() const
+{
+	return m_VAO;
+}
+
 /*static*/ void Drawable::SetPosHandle( GLint pH )
 {
 	s_PosHandle = pH;
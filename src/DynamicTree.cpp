@@ -0,0 +1,287 @@
+#include "DynamicTree.h"
+#include "GL_Util.h"
+
+#include <algorithm>
+
+// Perimeter is the 2D stand in for surface area
+static float perimeter( const Bounds& b )
+{
+	vec2 v2Ext = b.v2Max - b.v2Min;
+	return 2.f * (v2Ext.x + v2Ext.y);
+}
+
+static Bounds combine( const Bounds& a, const Bounds& b )
+{
+	Bounds ret = a;
+	ret.Merge( b );
+	return ret;
+}
+
+static bool contains( const Bounds& outer, const Bounds& inner )
+{
+	return outer.v2Min.x <= inner.v2Min.x && outer.v2Min.y <= inner.v2Min.y &&
+		inner.v2Max.x <= outer.v2Max.x && inner.v2Max.y <= outer.v2Max.y;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+DynamicTree::DynamicTree( float fMargin ) :
+	m_fMargin( fMargin ),
+	m_iRoot( -1 ),
+	m_iFreeList( -1 ),
+	m_nNodes( 0 ),
+	m_nProxies( 0 )
+{}
+
+int DynamicTree::allocNode()
+{
+	// Grow if the free list is empty
+	if ( m_iFreeList < 0 )
+	{
+		m_vNodes.emplace_back();
+		m_vNodes.back().iParent = -1;
+		m_iFreeList = (int) m_vNodes.size() - 1;
+	}
+
+	int iNode = m_iFreeList;
+	Node& n = m_vNodes[iNode];
+	m_iFreeList = n.iParent;
+	n.iParent = -1;
+	n.iChild1 = -1;
+	n.iChild2 = -1;
+	n.iHeight = 0;
+	n.uData = 0;
+	m_nNodes++;
+	return iNode;
+}
+
+void DynamicTree::freeNode( int iNode )
+{
+	m_vNodes[iNode].iParent = m_iFreeList;
+	m_vNodes[iNode].iHeight = -1;
+	m_iFreeList = iNode;
+	m_nNodes--;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+int DynamicTree::CreateProxy( const Bounds& bounds, uint32_t uData )
+{
+	int iProxy = allocNode();
+	Node& n = m_vNodes[iProxy];
+	n.bounds = { bounds.v2Min - vec2( m_fMargin ), bounds.v2Max + vec2( m_fMargin ) };
+	n.uData = uData;
+	insertLeaf( iProxy );
+	m_nProxies++;
+	return iProxy;
+}
+
+void DynamicTree::DestroyProxy( int iProxy )
+{
+	removeLeaf( iProxy );
+	freeNode( iProxy );
+	m_nProxies--;
+}
+
+bool DynamicTree::MoveProxy( int iProxy, const Bounds& bounds )
+{
+	// Nothing to do if we're still inside the fat bounds
+	if ( contains( m_vNodes[iProxy].bounds, bounds ) )
+		return false;
+
+	removeLeaf( iProxy );
+	m_vNodes[iProxy].bounds = { bounds.v2Min - vec2( m_fMargin ), bounds.v2Max + vec2( m_fMargin ) };
+	insertLeaf( iProxy );
+	return true;
+}
+
+uint32_t DynamicTree::GetData( int iProxy ) const
+{
+	return m_vNodes[iProxy].uData;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void DynamicTree::insertLeaf( int iLeaf )
+{
+	if ( m_iRoot < 0 )
+	{
+		m_iRoot = iLeaf;
+		m_vNodes[iLeaf].iParent = -1;
+		return;
+	}
+
+	// Walk down, picking the cheapest sibling by perimeter
+	const Bounds leafBounds = m_vNodes[iLeaf].bounds;
+	int iSibling = m_iRoot;
+	while ( m_vNodes[iSibling].IsLeaf() == false )
+	{
+		const Node& n = m_vNodes[iSibling];
+		float fArea = perimeter( n.bounds );
+		float fCombinedArea = perimeter( combine( n.bounds, leafBounds ) );
+
+		// Cost of making a new parent here, and the
+		// cost pushed down to whichever child we pick
+		float fCost = 2.f * fCombinedArea;
+		float fInheritCost = 2.f * (fCombinedArea - fArea);
+
+		float fChildCost[2];
+		int aiChildren[2] = { n.iChild1, n.iChild2 };
+		for ( int c = 0; c < 2; c++ )
+		{
+			const Node& child = m_vNodes[aiChildren[c]];
+			float fNewArea = perimeter( combine( child.bounds, leafBounds ) );
+			if ( child.IsLeaf() )
+				fChildCost[c] = fNewArea + fInheritCost;
+			else
+				fChildCost[c] = fNewArea - perimeter( child.bounds ) + fInheritCost;
+		}
+
+		if ( fCost < fChildCost[0] && fCost < fChildCost[1] )
+			break;
+
+		iSibling = fChildCost[0] < fChildCost[1] ? aiChildren[0] : aiChildren[1];
+	}
+
+	// Make a new parent for the sibling and the leaf
+	int iOldParent = m_vNodes[iSibling].iParent;
+	int iNewParent = allocNode();
+	Node& np = m_vNodes[iNewParent];
+	np.iParent = iOldParent;
+	np.bounds = combine( leafBounds, m_vNodes[iSibling].bounds );
+	np.iHeight = m_vNodes[iSibling].iHeight + 1;
+	np.iChild1 = iSibling;
+	np.iChild2 = iLeaf;
+	m_vNodes[iSibling].iParent = iNewParent;
+	m_vNodes[iLeaf].iParent = iNewParent;
+
+	if ( iOldParent < 0 )
+		m_iRoot = iNewParent;
+	else if ( m_vNodes[iOldParent].iChild1 == iSibling )
+		m_vNodes[iOldParent].iChild1 = iNewParent;
+	else
+		m_vNodes[iOldParent].iChild2 = iNewParent;
+
+	refitUp( m_vNodes[iLeaf].iParent );
+}
+
+void DynamicTree::removeLeaf( int iLeaf )
+{
+	if ( iLeaf == m_iRoot )
+	{
+		m_iRoot = -1;
+		return;
+	}
+
+	// Replace the parent with the leaf's sibling
+	int iParent = m_vNodes[iLeaf].iParent;
+	int iGrandParent = m_vNodes[iParent].iParent;
+	int iSibling = m_vNodes[iParent].iChild1 == iLeaf ? m_vNodes[iParent].iChild2 : m_vNodes[iParent].iChild1;
+
+	if ( iGrandParent < 0 )
+	{
+		m_iRoot = iSibling;
+		m_vNodes[iSibling].iParent = -1;
+		freeNode( iParent );
+		return;
+	}
+
+	if ( m_vNodes[iGrandParent].iChild1 == iParent )
+		m_vNodes[iGrandParent].iChild1 = iSibling;
+	else
+		m_vNodes[iGrandParent].iChild2 = iSibling;
+	m_vNodes[iSibling].iParent = iGrandParent;
+	freeNode( iParent );
+
+	refitUp( iGrandParent );
+}
+
+// Walk back up to the root fixing bounds and heights
+void DynamicTree::refitUp( int iNode )
+{
+	while ( iNode >= 0 )
+	{
+		iNode = balance( iNode );
+
+		Node& n = m_vNodes[iNode];
+		const Node& c1 = m_vNodes[n.iChild1];
+		const Node& c2 = m_vNodes[n.iChild2];
+		n.iHeight = 1 + std::max( c1.iHeight, c2.iHeight );
+		n.bounds = combine( c1.bounds, c2.bounds );
+
+		iNode = n.iParent;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// If one child of A is more than one level taller than the
+// other, rotate it up into A's place. Returns the new subtree root
+int DynamicTree::balance( int iA )
+{
+	Node& A = m_vNodes[iA];
+	if ( A.IsLeaf() || A.iHeight < 2 )
+		return iA;
+
+	int iB = A.iChild1;
+	int iC = A.iChild2;
+	int iBalance = m_vNodes[iC].iHeight - m_vNodes[iB].iHeight;
+	if ( iBalance > -2 && iBalance < 2 )
+		return iA;
+
+	// The taller child gets promoted
+	int iUp = iBalance > 1 ? iC : iB;
+	int iDown = iBalance > 1 ? iB : iC;
+	Node& Up = m_vNodes[iUp];
+	int iF = Up.iChild1;
+	int iG = Up.iChild2;
+
+	// Up takes A's spot
+	Up.iChild1 = iA;
+	Up.iParent = A.iParent;
+	A.iParent = iUp;
+	if ( Up.iParent < 0 )
+		m_iRoot = iUp;
+	else if ( m_vNodes[Up.iParent].iChild1 == iA )
+		m_vNodes[Up.iParent].iChild1 = iUp;
+	else
+		m_vNodes[Up.iParent].iChild2 = iUp;
+
+	// Up keeps its taller child, A gets the shorter one
+	int iKeep = m_vNodes[iF].iHeight > m_vNodes[iG].iHeight ? iF : iG;
+	int iGive = iKeep == iF ? iG : iF;
+	Up.iChild2 = iKeep;
+	if ( iBalance > 1 )
+		A.iChild2 = iGive;
+	else
+		A.iChild1 = iGive;
+	m_vNodes[iGive].iParent = iA;
+
+	const Node& D = m_vNodes[iDown];
+	const Node& N = m_vNodes[iGive];
+	A.bounds = combine( D.bounds, N.bounds );
+	A.iHeight = 1 + std::max( D.iHeight, N.iHeight );
+
+	const Node& K = m_vNodes[iKeep];
+	Up.bounds = combine( A.bounds, K.bounds );
+	Up.iHeight = 1 + std::max( A.iHeight, K.iHeight );
+
+	return iUp;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+int DynamicTree::GetHeight() const
+{
+	return m_iRoot < 0 ? 0 : m_vNodes[m_iRoot].iHeight;
+}
+
+int DynamicTree::GetNodeCount() const
+{
+	return m_nNodes;
+}
+
+int DynamicTree::GetProxyCount() const
+{
+	return m_nProxies;
+}
@@ -6,6 +6,8 @@
 #include <map>
 
 using EType = Shape::EType;
+using EBroadphase = Scene::EBroadphase;
+using ESolver = Scene::ESolver;
 
 using namespace pyl;
 
@@ -51,7 +53,7 @@ bool ExposeScene()
 	AddMemFnToMod( pModDef, Scene, AddDrawableIQM, int, std::string, vec2, vec2, vec4, float );
 	AddMemFnToMod( pModDef, Scene, AddSoftBody, int, EType, glm::vec2, std::map<std::string, float> );
 	AddMemFnToMod( pModDef, Scene, AddRigidBody, int, EType, vec2, vec2, float, float, std::map<std::string, float> );
-	AddMemFnToMod( pModDef, Scene, GetContacts, std::list<Contact *> );
+	AddMemFnToMod( pModDef, Scene, GetContacts, std::vector<Contact *> );
 	AddMemFnToMod( pModDef, Scene, GetQuitFlag, bool );
 	AddMemFnToMod( pModDef, Scene, SetQuitFlag, void, bool );
 	AddMemFnToMod( pModDef, Scene, GetDrawContacts, bool );
@@ -59,8 +61,87 @@ bool ExposeScene()
 	AddMemFnToMod( pModDef, Scene, GetPauseCollision, bool );
 	AddMemFnToMod( pModDef, Scene, SetPauseCollision, void, bool );
 	AddMemFnToMod( pModDef, Scene, GetIsColliding, bool, Shape *, Shape * );
+	AddMemFnToMod( pModDef, Scene, GetCollisionEvents, std::vector<int> );
+	AddMemFnToMod( pModDef, Scene, SetBroadphase, void, EBroadphase );
+	AddMemFnToMod( pModDef, Scene, GetBroadphase, EBroadphase );
+	AddMemFnToMod( pModDef, Scene, SetPlaneMargin, void, float );
+	AddMemFnToMod( pModDef, Scene, GetPlaneMargin, float );
+	AddMemFnToMod( pModDef, Scene, GetNumPlaneContacts, int );
+	AddMemFnToMod( pModDef, Scene, SetCullContacts, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetCullContacts, bool );
+	AddMemFnToMod( pModDef, Scene, SetCullMargin, void, float );
+	AddMemFnToMod( pModDef, Scene, GetCullMargin, float );
+	AddMemFnToMod( pModDef, Scene, GetNumCulledContacts, int );
+	AddMemFnToMod( pModDef, Scene, GetNumBroadphasePairs, int );
+	AddMemFnToMod( pModDef, Scene, GetNumBodyPairs, int );
+	AddMemFnToMod( pModDef, Scene, GetSoftTreeHeight, int );
+	AddMemFnToMod( pModDef, Scene, GetSoftTreeNodeCount, int );
+	AddMemFnToMod( pModDef, Scene, SetSolverIterations, void, int );
+	AddMemFnToMod( pModDef, Scene, GetSolverIterations, int );
+	AddMemFnToMod( pModDef, Scene, GetLastSolverIterations, int );
+	AddMemFnToMod( pModDef, Scene, SetSolverMode, void, ESolver );
+	AddMemFnToMod( pModDef, Scene, GetSolverMode, ESolver );
+	AddMemFnToMod( pModDef, Scene, GetIslandIterations, std::vector<int> );
+	AddMemFnToMod( pModDef, Scene, SetWarmStartFactor, void, float );
+	AddMemFnToMod( pModDef, Scene, GetWarmStartFactor, float );
+	AddMemFnToMod( pModDef, Scene, GetNumWarmStarted, int );
+	AddMemFnToMod( pModDef, Scene, SetBatchNarrowphase, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetBatchNarrowphase, bool );
+	AddMemFnToMod( pModDef, Scene, SetSIMDIntegrate, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetSIMDIntegrate, bool );
+	AddMemFnToMod( pModDef, Scene, SetBucketNarrowphase, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetBucketNarrowphase, bool );
+	AddMemFnToMod( pModDef, Scene, SetThreadCount, void, int );
+	AddMemFnToMod( pModDef, Scene, GetThreadCount, int );
+	AddMemFnToMod( pModDef, Scene, SetSleepEnabled, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetSleepEnabled, bool );
+	AddMemFnToMod( pModDef, Scene, SetSleepEnergy, void, float );
+	AddMemFnToMod( pModDef, Scene, SetTimeToSleep, void, float );
+	AddMemFnToMod( pModDef, Scene, GetNumAsleep, int );
+	AddMemFnToMod( pModDef, Scene, GetNumSlept, int );
+	AddMemFnToMod( pModDef, Scene, GetNumWoken, int );
+	AddMemFnToMod( pModDef, Scene, GetNumIslands, int );
+	AddMemFnToMod( pModDef, Scene, SetTimeStep, void, float );
+	AddMemFnToMod( pModDef, Scene, GetTimeStep, float );
+	AddMemFnToMod( pModDef, Scene, SetMaxSubsteps, void, int );
+	AddMemFnToMod( pModDef, Scene, GetMaxSubsteps, int );
+	AddMemFnToMod( pModDef, Scene, SetRealTime, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetRealTime, bool );
+	AddMemFnToMod( pModDef, Scene, SetInterpolate, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetInterpolate, bool );
+	AddMemFnToMod( pModDef, Scene, GetLastSubsteps, int );
+	AddMemFnToMod( pModDef, Scene, GetInterpAlpha, float );
 	AddMemFnToMod( pModDef, Scene, Update, void );
+	AddMemFnToMod( pModDef, Scene, Step, void, int );
+	AddMemFnToMod( pModDef, Scene, SetGravity, void, vec2 );
+	AddMemFnToMod( pModDef, Scene, GetGravity, vec2 );
+	AddMemFnToMod( pModDef, Scene, AddAttractor, int, vec2, float, float );
+	AddMemFnToMod( pModDef, Scene, SetAttractorPos, void, int, vec2 );
+	AddMemFnToMod( pModDef, Scene, SetAttractorActive, void, int, bool );
+	AddMemFnToMod( pModDef, Scene, ClearAttractors, void );
+	AddMemFnToMod( pModDef, Scene, SetHeadless, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetHeadless, bool );
 	AddMemFnToMod( pModDef, Scene, Draw, void );
+	AddMemFnToMod( pModDef, Scene, BindRigidBodyDrawable, bool, int, int );
+	AddMemFnToMod( pModDef, Scene, BindSoftBodyDrawable, bool, int, int );
+	AddMemFnToMod( pModDef, Scene, UnbindDrawable, void, int );
+	AddMemFnToMod( pModDef, Scene, InitInstancing, bool, std::string, std::string );
+	AddMemFnToMod( pModDef, Scene, SetInstancedDraw, void, bool );
+	AddMemFnToMod( pModDef, Scene, GetInstancedDraw, bool );
+	AddMemFnToMod( pModDef, Scene, GetNumDrawCalls, int );
+	AddMemFnToMod( pModDef, Scene, GetPersistentMapping, bool );
+	AddMemFnToMod( pModDef, Scene, GetNumStalledFrames, int );
+
+	pModDef->SetCustomModuleInit( [] ( pyl::Object obModule )
+	{
+		obModule.set_attr( "SortAndSweep", EBroadphase::SortAndSweep );
+		obModule.set_attr( "UniformGrid", EBroadphase::UniformGrid );
+		obModule.set_attr( "SerialSolver", ESolver::Serial );
+		obModule.set_attr( "IslandSolver", ESolver::Islands );
+		obModule.set_attr( "CollisionBegin", (int) CollisionEvent::EType::Begin );
+		obModule.set_attr( "CollisionPersist", (int) CollisionEvent::EType::Persist );
+		obModule.set_attr( "CollisionEnd", (int) CollisionEvent::EType::End );
+	} );
 
 	return true;
 }
@@ -77,7 +158,21 @@ bool ExposeShader()
 	AddMemFnToMod( pModDef, Shader, PrintSrc_V, int );
 	AddMemFnToMod( pModDef, Shader, PrintSrc_F, int );
 	AddMemFnToMod( pModDef, Shader, PrintLog_P, int );
-	AddMemFnToMod( pModDef, Shader, GetHandle, GLint, const std::string );
+
+	// GetHandle is overloaded, so pick the string one by hand
+	std::function<GLint( Shader *, const std::string )> fnGetHandle = static_cast<GLint( Shader::* )( const std::string )>( &Shader::GetHandle );
+	pModDef->RegisterMemFunction<Shader, struct __st_fnShaderGetHandle>( "GetHandle", fnGetHandle );
+	AddMemFnToMod( pModDef, Shader, GetHandleByID, GLint, int );
+
+	pModDef->SetCustomModuleInit( [] ( pyl::Object obModule )
+	{
+		obModule.set_attr( "HandlePMV", (int) Shader::EHandle::PMV );
+		obModule.set_attr( "HandleColor", (int) Shader::EHandle::Color );
+		obModule.set_attr( "HandleCamMat", (int) Shader::EHandle::CamMat );
+		obModule.set_attr( "HandlePos", (int) Shader::EHandle::Pos );
+		obModule.set_attr( "HandleMV", (int) Shader::EHandle::MV );
+		obModule.set_attr( "HandleInstColor", (int) Shader::EHandle::InstColor );
+	} );
 
 	return true;
 }
@@ -169,6 +264,9 @@ bool ExposeRigidBody2D()
 	AddMemFnToMod( pModDef, RigidBody2D, SetForce, void, vec2 );
 	AddMemFnToMod( pModDef, RigidBody2D, ApplyForce, void, vec2 );
 	AddMemFnToMod( pModDef, RigidBody2D, GetMass, float );
+	AddMemFnToMod( pModDef, RigidBody2D, GetInvMass, float );
+	AddMemFnToMod( pModDef, RigidBody2D, GetIsAsleep, bool );
+	AddMemFnToMod( pModDef, RigidBody2D, Wake, void );
 
 	return true;
 }
@@ -261,6 +359,26 @@ namespace pyl
 		return PyLong_FromLong( (long) e );
 	}
 
+	bool convert( PyObject * o, Scene::EBroadphase& e )
+	{
+		return convertEnum<EBroadphase>( o, e );
+	}
+
+	PyObject * alloc_pyobject( const EBroadphase e )
+	{
+		return PyLong_FromLong( (long) e );
+	}
+
+	bool convert( PyObject * o, Scene::ESolver& e )
+	{
+		return convertEnum<ESolver>( o, e );
+	}
+
+	PyObject * alloc_pyobject( const ESolver e )
+	{
+		return PyLong_FromLong( (long) e );
+	}
+
 	PyObject * alloc_pyobject( const vec2& v )
 	{
 		PyObject * pRet = PyList_New( 2 );
@@ -0,0 +1,93 @@
+#include "IslandGraph.h"
+
+#include <utility>
+
+IslandGraph::IslandGraph()
+{}
+
+void IslandGraph::Reset( size_t nBodies )
+{
+	m_vParent.resize( nBodies );
+	m_vSize.assign( nBodies, 1 );
+	for ( uint32_t i = 0; i < (uint32_t) nBodies; i++ )
+		m_vParent[i] = i;
+
+	m_vIslandOf.clear();
+	m_vIslandStart.clear();
+	m_vBodies.clear();
+}
+
+// Path halving keeps the trees flat without recursion
+uint32_t IslandGraph::find( uint32_t uBody )
+{
+	while ( m_vParent[uBody] != uBody )
+	{
+		m_vParent[uBody] = m_vParent[m_vParent[uBody]];
+		uBody = m_vParent[uBody];
+	}
+	return uBody;
+}
+
+void IslandGraph::Link( uint32_t uBodyA, uint32_t uBodyB )
+{
+	uint32_t uRootA = find( uBodyA );
+	uint32_t uRootB = find( uBodyB );
+	if ( uRootA == uRootB )
+		return;
+
+	// Hang the smaller set off the bigger one
+	if ( m_vSize[uRootA] < m_vSize[uRootB] )
+		std::swap( uRootA, uRootB );
+	m_vParent[uRootB] = uRootA;
+	m_vSize[uRootA] += m_vSize[uRootB];
+}
+
+void IslandGraph::Build()
+{
+	const uint32_t N = (uint32_t) m_vParent.size();
+	const uint32_t uNone = ~0u;
+
+	// Number the roots in body order, so islands come out
+	// in the order of their lowest body (handy for determinism)
+	m_vRootIsland.assign( N, uNone );
+	m_vIslandOf.resize( N );
+	m_vIslandStart.clear();
+	for ( uint32_t i = 0; i < N; i++ )
+	{
+		uint32_t uRoot = find( i );
+		if ( m_vRootIsland[uRoot] == uNone )
+		{
+			m_vRootIsland[uRoot] = (uint32_t) m_vIslandStart.size();
+			m_vIslandStart.push_back( 0 );
+		}
+		m_vIslandOf[i] = m_vRootIsland[uRoot];
+	}
+
+	// Counting sort bodies by island
+	m_vCount.assign( m_vIslandStart.size() + 1, 0 );
+	for ( uint32_t i = 0; i < N; i++ )
+		m_vCount[m_vIslandOf[i] + 1]++;
+	for ( size_t i = 1; i < m_vCount.size(); i++ )
+		m_vCount[i] += m_vCount[i - 1];
+	m_vIslandStart.assign( m_vCount.begin(), m_vCount.end() );
+
+	m_vBodies.resize( N );
+	for ( uint32_t i = 0; i < N; i++ )
+		m_vBodies[m_vCount[m_vIslandOf[i]]++] = i;
+}
+
+size_t IslandGraph::GetNumIslands() const
+{
+	return m_vIslandStart.empty() ? 0 : m_vIslandStart.size() - 1;
+}
+
+uint32_t IslandGraph::GetIsland( uint32_t uBody ) const
+{
+	return m_vIslandOf[uBody];
+}
+
+Span<const uint32_t> IslandGraph::GetIslandBodies( size_t uIsland ) const
+{
+	const uint32_t * pBodies = m_vBodies.data();
+	return Span<const uint32_t>( pBodies + m_vIslandStart[uIsland], pBodies + m_vIslandStart[uIsland + 1] );
+}
@@ -0,0 +1,136 @@
+#include "JobPool.h"
+
+#include <algorithm>
+
+JobPool::JobPool() :
+	m_nJobs( 0 ),
+	m_nNextJob( 0 ),
+	m_nJobsLeft( 0 ),
+	m_uGeneration( 0 ),
+	m_bStop( false )
+{}
+
+JobPool::~JobPool()
+{
+	stopWorkers();
+}
+
+void JobPool::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_bStop = true;
+	}
+	m_cvWork.notify_all();
+	for ( std::thread& t : m_vWorkers )
+		t.join();
+	m_vWorkers.clear();
+	m_bStop = false;
+}
+
+void JobPool::SetThreadCount( uint32_t nThreads )
+{
+	if ( nThreads == 0 )
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+
+	if ( nThreads == GetThreadCount() )
+		return;
+
+	// Start over with the right number of workers
+	stopWorkers();
+	for ( uint32_t i = 1; i < nThreads; i++ )
+		m_vWorkers.emplace_back( &JobPool::workerLoop, this );
+}
+
+uint32_t JobPool::GetThreadCount() const
+{
+	return (uint32_t) m_vWorkers.size() + 1;
+}
+
+size_t JobPool::GetNumChunks( size_t N ) const
+{
+	return std::min<size_t>( N, GetThreadCount() );
+}
+
+// Grab jobs until there are none left. The lock is only held
+// to take a job number or to report one finished
+void JobPool::drainJobs()
+{
+	std::unique_lock<std::mutex> lock( m_Mutex );
+	while ( m_nNextJob < m_nJobs )
+	{
+		size_t uJob = m_nNextJob++;
+		lock.unlock();
+
+		std::exception_ptr pEx;
+		try
+		{
+			m_fnJob( uJob );
+		}
+		catch ( ... )
+		{
+			pEx = std::current_exception();
+		}
+
+		lock.lock();
+		if ( pEx && !m_pException )
+			m_pException = pEx;
+		if ( --m_nJobsLeft == 0 )
+			m_cvDone.notify_all();
+	}
+}
+
+void JobPool::workerLoop()
+{
+	uint64_t uSeen = 0;
+	for ( ;; )
+	{
+		{
+			std::unique_lock<std::mutex> lock( m_Mutex );
+			m_cvWork.wait( lock, [this, uSeen] () { return m_bStop || m_uGeneration != uSeen; } );
+			if ( m_bStop )
+				return;
+			uSeen = m_uGeneration;
+		}
+		drainJobs();
+	}
+}
+
+void JobPool::Run( size_t nJobs, std::function<void( size_t )> fnJob )
+{
+	if ( nJobs == 0 )
+		return;
+
+	// No workers, just do it here
+	if ( m_vWorkers.empty() )
+	{
+		for ( size_t i = 0; i < nJobs; i++ )
+			fnJob( i );
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_fnJob = std::move( fnJob );
+		m_pException = nullptr;
+		m_nJobs = nJobs;
+		m_nNextJob = 0;
+		m_nJobsLeft = nJobs;
+		m_uGeneration++;
+	}
+	m_cvWork.notify_all();
+
+	// Pitch in, then wait for the stragglers
+	drainJobs();
+
+	std::exception_ptr pEx;
+	{
+		std::unique_lock<std::mutex> lock( m_Mutex );
+		m_cvDone.wait( lock, [this] () { return m_nJobsLeft == 0; } );
+		m_fnJob = nullptr;
+		std::swap( pEx, m_pException );
+	}
+
+	if ( pEx )
+		std::rethrow_exception( pEx );
+}
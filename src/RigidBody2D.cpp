@@ -9,14 +9,14 @@
 // Euler integrate rigid body translation/rotation
 void EulerAdvance( RigidBody2D * pRB, float fDT )
 {
-	vec2 v2Accel = pRB->v2Force / pRB->fMass;
+	vec2 v2Accel = pRB->v2Force * pRB->fInvMass;
 	pRB->v2Center += fDT * pRB->v2Vel;
 	pRB->v2Vel += fDT * v2Accel;
 }
 
 void VerletAdvance( RigidBody2D * pRB, float fDT )
 {
-	vec2 v2Accel = pRB->v2Force / pRB->fMass;
+	vec2 v2Accel = pRB->v2Force * pRB->fInvMass;
 	pRB->v2Center += fDT * ( pRB->v2Vel + 0.5f * fDT * v2Accel );
 	pRB->v2Vel += fDT * v2Accel;
 }
@@ -42,19 +42,40 @@ float RigidBody2D::GetMass() const
 	return fMass;
 }
 
+float RigidBody2D::GetInvMass() const
+{
+	return fInvMass;
+}
+
+bool RigidBody2D::GetIsAsleep() const
+{
+	return bAsleep;
+}
+
+void RigidBody2D::Wake()
+{
+	bAsleep = false;
+	fRestTime = 0;
+}
+
 RigidBody2D::RigidBody2D() :
 	Shape(),
 	fMass( 0 ),
-	fElast( 0 )
+	fInvMass( 0 ),
+	fElast( 0 ),
+	bAsleep( false ),
+	fRestTime( 0 )
 {}
 
 Shape::Shape() :
 	bActive( false ),
+	bMoved( false ),
 	eType( EType::None )
 {}
 
 Shape::Shape( glm::vec2 v2C ) :
 	bActive( false ),
+	bMoved( false ),
 	eType( EType::None ),
 	v2Center( v2C )
 {}
@@ -62,6 +83,7 @@ Shape::Shape( glm::vec2 v2C ) :
 void Shape::SetCenterPos( glm::vec2 v2Pos )
 {
 	v2Center = v2Pos;
+	bMoved = true;
 }
 
 vec2 Shape::Position() const
@@ -77,8 +99,11 @@ Shape::EType Shape::Type() const
 RigidBody2D::RigidBody2D( glm::vec2 vel, glm::vec2 c, float mass, float elasticity ) :
 	Shape( c ), 
 	fMass( mass ),
+	fInvMass( mass > 0 ? 1.f / mass : 0.f ),
 	fElast( elasticity ),
-	v2Vel( vel )
+	v2Vel( vel ),
+	bAsleep( false ),
+	fRestTime( 0 )
 {}
 
 SoftBody2D Triangle::Create( glm::vec2 c, glm::vec2 A, glm::vec2 B, glm::vec2 C )
@@ -109,104 +134,78 @@ bool Shape::GetIsActive() const
 
 ////////////////////////////////////////////////////////////////////////////
 
-/*static*/ Contact GetSpeculativeContact( const RigidBody2D * pA, const RigidBody2D * pB )
+// The [EType][EType] tables below get filled with these, one instantiation
+// per supported combination. The Swap versions are for combos that only
+// have a function with the arguments the other way around
+template <typename TA, typename TB>
+static Contact specContact( const RigidBody2D * pA, const RigidBody2D * pB )
 {
-	using EType = RigidBody2D::EType;
-	switch ( pA->eType )
-	{
-		case EType::Circle:
-		{
-			Circle * pCircA = (Circle *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return GetSpecContact( pCircA, (Circle *) pB );
-				case EType::AABB:
-					return GetSpecContact( pCircA, (AABB *) pB );
-				default:
-					break;
-			}
-			break;
-		}
-		case EType::AABB:
-		{
-			AABB * pBoxA = (AABB *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return GetSpecContact( (Circle *) pB, pBoxA );
-				case EType::AABB:
-					return GetSpecContact( pBoxA, (AABB *) pB );
-				default:
-					break;
-			}
-			break;
-		}
-	}
+	return GetSpecContact( (TA *) pA, (TB *) pB );
+}
 
+template <typename TA, typename TB>
+static Contact specContactSwap( const RigidBody2D * pA, const RigidBody2D * pB )
+{
+	return GetSpecContact( (TB *) pB, (TA *) pA );
+}
+
+static Contact specContactInvalid( const RigidBody2D * pA, const RigidBody2D * pB )
+{
 	throw std::runtime_error( "Error: Invalid rigid body type!" );
 	return Contact();
 }
 
-////////////////////////////////////////////////////////////////////////////
+template <typename TA, typename TB>
+static bool isOverlapping( const Shape * pA, const Shape * pB )
+{
+	return IsOverlapping( (TA *) pA, (TB *) pB );
+}
 
-/*static*/ bool IsOverlapping( const Shape * pA, const Shape * pB )
+template <typename TA, typename TB>
+static bool isOverlappingSwap( const Shape * pA, const Shape * pB )
 {
-	using EType = Shape::EType;
-	switch ( pA->eType )
-	{
-		case EType::Circle:
-		{
-			Circle * pCircA = (Circle *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return IsOverlapping( pCircA, (Circle *) pB );
-				case EType::AABB:
-					return IsOverlapping( pCircA, (AABB *) pB );
-				case EType::Triangle:
-					return IsOverlapping( pCircA, (Triangle *) pB );
-				default:
-					break;
-			}
-			break;
-		}
-		case EType::AABB:
-		{
-			AABB * pBoxA = (AABB *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return IsOverlapping( (Circle *) pB, pBoxA );
-				case EType::AABB:
-					return IsOverlapping( pBoxA, (AABB *) pB );
-				case EType::Triangle:
-					return IsOverlapping( pBoxA, (Triangle *) pB );
-				default:
-					break;
-			}
-			break;
-		}
-		case EType::Triangle:
-		{
-			Triangle * pTriA = (Triangle *) pA;
-			switch ( pB->eType )
-			{
-				case EType::Circle:
-					return IsOverlapping( (Circle *) pB, pTriA );
-				case EType::AABB:
-					return IsOverlapping( (AABB *) pB, pTriA );
-				default:
-					break;
-			}
-			break;
-		}
-	}
+	return IsOverlapping( (TB *) pB, (TA *) pA );
+}
 
+static bool isOverlappingInvalid( const Shape * pA, const Shape * pB )
+{
 	throw std::runtime_error( "Error: Invalid rigid body type!" );
 	return false;
 }
 
+using OverlapFn = bool( *)(const Shape *, const Shape *);
+// Rows are A's type, columns are B's (None, Circle, AABB, Triangle)
+static const SpecContactFn s_aSpecContactFns[Shape::kNumTypes][Shape::kNumTypes] = {
+	{ specContactInvalid, specContactInvalid, specContactInvalid, specContactInvalid },
+	{ specContactInvalid, specContact<Circle, Circle>, specContact<Circle, AABB>, specContactInvalid },
+	{ specContactInvalid, specContactSwap<AABB, Circle>, specContact<AABB, AABB>, specContactInvalid },
+	{ specContactInvalid, specContactInvalid, specContactInvalid, specContactInvalid }
+};
+
+static const OverlapFn s_aOverlapFns[Shape::kNumTypes][Shape::kNumTypes] = {
+	{ isOverlappingInvalid, isOverlappingInvalid, isOverlappingInvalid, isOverlappingInvalid },
+	{ isOverlappingInvalid, isOverlapping<Circle, Circle>, isOverlapping<Circle, AABB>, isOverlapping<Circle, Triangle> },
+	{ isOverlappingInvalid, isOverlappingSwap<AABB, Circle>, isOverlapping<AABB, AABB>, isOverlapping<AABB, Triangle> },
+	{ isOverlappingInvalid, isOverlappingSwap<Triangle, Circle>, isOverlappingSwap<Triangle, AABB>, isOverlappingInvalid }
+};
+
+SpecContactFn GetSpecContactFn( const Shape * pA, const Shape * pB )
+{
+	return s_aSpecContactFns[(int) pA->eType][(int) pB->eType];
+}
+
+/*static*/ Contact GetSpeculativeContact( const RigidBody2D * pA, const RigidBody2D * pB )
+{
+	return s_aSpecContactFns[(int) pA->eType][(int) pB->eType]( pA, pB );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+/*static*/ bool IsOverlapping( const Shape * pA, const Shape * pB )
+{
+	return s_aOverlapFns[(int) pA->eType][(int) pB->eType]( pA, pB );
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 /*static*/ Contact GetSpeculativeContact( const Plane * pPlane, const RigidBody2D * pB )
@@ -0,0 +1,206 @@
+#include "RigidBodyStore.h"
+#include "RigidBody2D.h"
+#include "GL_Util.h"
+
+// SRB_NO_SIMD forces the scalar loop, like in ContactKernels.cpp
+#if defined( SRB_NO_SIMD )
+#elif defined( __AVX__ )
+#define SRB_AVX
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define SRB_SSE
+#include <xmmintrin.h>
+#endif
+
+RigidBodyStore::RigidBodyStore()
+{}
+
+void RigidBodyStore::resize( size_t N )
+{
+	for ( std::vector<float> * pV : { &m_vPosX, &m_vPosY, &m_vVelX, &m_vVelY, &m_vInvMass, &m_vActive, &m_vExtX, &m_vExtY } )
+		pV->resize( N );
+}
+
+// Integrating the bodies where they are and copying them out in the same
+// pass beat loading the arrays, integrating them with SIMD and writing
+// them back (IntegrateSIMD), so it's what the Scene uses by default
+void RigidBodyStore::Integrate( std::vector<RigidBody2D>& vBodies, float fDT )
+{
+	size_t N = vBodies.size();
+	resize( N );
+
+	for ( size_t i = 0; i < N; i++ )
+	{
+		RigidBody2D& rb = vBodies[i];
+		bool bActive = rb.GetIsActive() && rb.bAsleep == false;
+		if ( bActive )
+			rb.Integrate( fDT );
+
+		m_vPosX[i] = rb.v2Center.x;
+		m_vPosY[i] = rb.v2Center.y;
+		m_vVelX[i] = rb.v2Vel.x;
+		m_vVelY[i] = rb.v2Vel.y;
+		m_vInvMass[i] = rb.fInvMass;
+		m_vActive[i] = bActive ? 1.f : 0.f;
+
+		// Only circles and boxes are rigid
+		bool bCircle = rb.eType == RigidBody2D::EType::Circle;
+		m_vExtX[i] = bCircle ? rb.fRadius : rb.v2HalfDim.x;
+		m_vExtY[i] = bCircle ? rb.fRadius : rb.v2HalfDim.y;
+	}
+}
+
+void RigidBodyStore::IntegrateSIMD( std::vector<RigidBody2D>& vBodies, float fDT )
+{
+	load( vBodies );
+	integrateArrays( fDT );
+	store( vBodies );
+}
+
+void RigidBodyStore::load( const std::vector<RigidBody2D>& vBodies )
+{
+	size_t N = vBodies.size();
+	resize( N );
+	m_vForceX.resize( N );
+	m_vForceY.resize( N );
+
+	for ( size_t i = 0; i < N; i++ )
+	{
+		const RigidBody2D& rb = vBodies[i];
+		m_vPosX[i] = rb.v2Center.x;
+		m_vPosY[i] = rb.v2Center.y;
+		m_vVelX[i] = rb.v2Vel.x;
+		m_vVelY[i] = rb.v2Vel.y;
+		m_vForceX[i] = rb.v2Force.x;
+		m_vForceY[i] = rb.v2Force.y;
+		m_vInvMass[i] = rb.fInvMass;
+		m_vActive[i] = rb.GetIsActive() && rb.bAsleep == false ? 1.f : 0.f;
+
+		bool bCircle = rb.eType == RigidBody2D::EType::Circle;
+		m_vExtX[i] = bCircle ? rb.fRadius : rb.v2HalfDim.x;
+		m_vExtY[i] = bCircle ? rb.fRadius : rb.v2HalfDim.y;
+	}
+}
+
+// Same math as VerletAdvance, with dt scaled by the active flag
+// so that inactive bodies come out the other side untouched
+void RigidBodyStore::integrateArrays( float fDT )
+{
+	const size_t N = Size();
+	float * pPX = m_vPosX.data(), * pPY = m_vPosY.data();
+	float * pVX = m_vVelX.data(), * pVY = m_vVelY.data();
+	const float * pFX = m_vForceX.data(), * pFY = m_vForceY.data();
+	const float * pIM = m_vInvMass.data(), * pA = m_vActive.data();
+
+	size_t i = 0;
+#if defined( SRB_AVX )
+	const __m256 vDT = _mm256_set1_ps( fDT );
+	const __m256 vHalfDT = _mm256_set1_ps( 0.5f * fDT );
+	for ( ; i + 8 <= N; i += 8 )
+	{
+		__m256 vDTa = _mm256_mul_ps( vDT, _mm256_loadu_ps( pA + i ) );
+		__m256 vIM = _mm256_loadu_ps( pIM + i );
+		__m256 vAX = _mm256_mul_ps( _mm256_loadu_ps( pFX + i ), vIM );
+		__m256 vAY = _mm256_mul_ps( _mm256_loadu_ps( pFY + i ), vIM );
+		__m256 vVX = _mm256_loadu_ps( pVX + i );
+		__m256 vVY = _mm256_loadu_ps( pVY + i );
+		__m256 vDX = _mm256_mul_ps( vDTa, _mm256_add_ps( vVX, _mm256_mul_ps( vHalfDT, vAX ) ) );
+		__m256 vDY = _mm256_mul_ps( vDTa, _mm256_add_ps( vVY, _mm256_mul_ps( vHalfDT, vAY ) ) );
+		_mm256_storeu_ps( pPX + i, _mm256_add_ps( _mm256_loadu_ps( pPX + i ), vDX ) );
+		_mm256_storeu_ps( pPY + i, _mm256_add_ps( _mm256_loadu_ps( pPY + i ), vDY ) );
+		_mm256_storeu_ps( pVX + i, _mm256_add_ps( vVX, _mm256_mul_ps( vDTa, vAX ) ) );
+		_mm256_storeu_ps( pVY + i, _mm256_add_ps( vVY, _mm256_mul_ps( vDTa, vAY ) ) );
+	}
+#elif defined( SRB_SSE )
+	const __m128 vDT = _mm_set1_ps( fDT );
+	const __m128 vHalfDT = _mm_set1_ps( 0.5f * fDT );
+	for ( ; i + 4 <= N; i += 4 )
+	{
+		__m128 vDTa = _mm_mul_ps( vDT, _mm_loadu_ps( pA + i ) );
+		__m128 vIM = _mm_loadu_ps( pIM + i );
+		__m128 vAX = _mm_mul_ps( _mm_loadu_ps( pFX + i ), vIM );
+		__m128 vAY = _mm_mul_ps( _mm_loadu_ps( pFY + i ), vIM );
+		__m128 vVX = _mm_loadu_ps( pVX + i );
+		__m128 vVY = _mm_loadu_ps( pVY + i );
+		__m128 vDX = _mm_mul_ps( vDTa, _mm_add_ps( vVX, _mm_mul_ps( vHalfDT, vAX ) ) );
+		__m128 vDY = _mm_mul_ps( vDTa, _mm_add_ps( vVY, _mm_mul_ps( vHalfDT, vAY ) ) );
+		_mm_storeu_ps( pPX + i, _mm_add_ps( _mm_loadu_ps( pPX + i ), vDX ) );
+		_mm_storeu_ps( pPY + i, _mm_add_ps( _mm_loadu_ps( pPY + i ), vDY ) );
+		_mm_storeu_ps( pVX + i, _mm_add_ps( vVX, _mm_mul_ps( vDTa, vAX ) ) );
+		_mm_storeu_ps( pVY + i, _mm_add_ps( vVY, _mm_mul_ps( vDTa, vAY ) ) );
+	}
+#endif
+
+	// Scalar tail (or everything, without SSE)
+	for ( ; i < N; i++ )
+	{
+		float fDTa = fDT * pA[i];
+		float fAX = pFX[i] * pIM[i];
+		float fAY = pFY[i] * pIM[i];
+		pPX[i] += fDTa * (pVX[i] + 0.5f * fDT * fAX);
+		pPY[i] += fDTa * (pVY[i] + 0.5f * fDT * fAY);
+		pVX[i] += fDTa * fAX;
+		pVY[i] += fDTa * fAY;
+	}
+}
+
+// Only active bodies moved, so only they get written back
+// (and have their force zeroed, like RigidBody2D::Integrate)
+void RigidBodyStore::store( std::vector<RigidBody2D>& vBodies ) const
+{
+	for ( size_t i = 0; i < vBodies.size(); i++ )
+	{
+		if ( m_vActive[i] == 0 )
+			continue;
+
+		RigidBody2D& rb = vBodies[i];
+		rb.v2Center = vec2( m_vPosX[i], m_vPosY[i] );
+		rb.v2Vel = vec2( m_vVelX[i], m_vVelY[i] );
+		rb.v2Force = vec2();
+	}
+}
+
+size_t RigidBodyStore::Size() const
+{
+	return m_vPosX.size();
+}
+
+const float * RigidBodyStore::PosX() const
+{
+	return m_vPosX.data();
+}
+
+const float * RigidBodyStore::PosY() const
+{
+	return m_vPosY.data();
+}
+
+const float * RigidBodyStore::VelX() const
+{
+	return m_vVelX.data();
+}
+
+const float * RigidBodyStore::VelY() const
+{
+	return m_vVelY.data();
+}
+
+const float * RigidBodyStore::ExtX() const
+{
+	return m_vExtX.data();
+}
+
+const float * RigidBodyStore::ExtY() const
+{
+	return m_vExtY.data();
+}
+
+const float * RigidBodyStore::InvMass() const
+{
+	return m_vInvMass.data();
+}
+
+const float * RigidBodyStore::Active() const
+{
+	return m_vActive.data();
+}
@@ -0,0 +1,166 @@
+#include "RingBuffer.h"
+
+#include <algorithm>
+
+RingBuffer::RingBuffer() :
+	m_bPersistent( false ),
+	m_Buffer( 0 ),
+	m_uRegionBytes( 0 ),
+	m_uMappedBytes( 0 ),
+	m_ixRegion( 0 ),
+	m_pMapped( nullptr ),
+	m_nStalls( 0 )
+{
+	m_aFences.fill( nullptr );
+}
+
+bool RingBuffer::Init( size_t uRegionBytes )
+{
+	Destroy();
+	m_bPersistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+	return allocate( uRegionBytes );
+}
+
+void RingBuffer::Destroy()
+{
+	for ( GLsync& sync : m_aFences )
+	{
+		if ( sync )
+			glDeleteSync( sync );
+		sync = nullptr;
+	}
+
+	if ( m_Buffer )
+	{
+		if ( m_pMapped )
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+			glUnmapBuffer( GL_ARRAY_BUFFER );
+			glBindBuffer( GL_ARRAY_BUFFER, 0 );
+		}
+		glDeleteBuffers( 1, &m_Buffer );
+	}
+
+	m_Buffer = 0;
+	m_pMapped = nullptr;
+	m_uRegionBytes = 0;
+	m_ixRegion = 0;
+	m_vStaging.clear();
+}
+
+// Persistent storage is immutable, so growing means a new buffer
+bool RingBuffer::allocate( size_t uRegionBytes )
+{
+	// Keep region offsets aligned
+	m_uRegionBytes = (uRegionBytes + 255) & ~(size_t) 255;
+
+	if ( m_bPersistent == false )
+	{
+		m_vStaging.resize( m_uRegionBytes );
+		if ( m_Buffer == 0 )
+			glGenBuffers( 1, &m_Buffer );
+		return m_Buffer != 0;
+	}
+
+	// Nothing can still be reading the old one
+	for ( int i = 0; i < kNumRegions; i++ )
+		waitForRegion( i );
+
+	if ( m_Buffer )
+	{
+		if ( m_pMapped )
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+			glUnmapBuffer( GL_ARRAY_BUFFER );
+		}
+		glDeleteBuffers( 1, &m_Buffer );
+		m_Buffer = 0;
+		m_pMapped = nullptr;
+	}
+
+	glGenBuffers( 1, &m_Buffer );
+	if ( m_Buffer == 0 )
+		return false;
+
+	const GLbitfield uFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const GLsizeiptr uTotalBytes = kNumRegions * m_uRegionBytes;
+	glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+	glBufferStorage( GL_ARRAY_BUFFER, uTotalBytes, nullptr, uFlags );
+	m_pMapped = (uint8_t *) glMapBufferRange( GL_ARRAY_BUFFER, 0, uTotalBytes, uFlags );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	m_ixRegion = 0;
+	return m_pMapped != nullptr;
+}
+
+// Returns true if the GPU wasn't done with the region yet
+bool RingBuffer::waitForRegion( int ixRegion )
+{
+	GLsync& sync = m_aFences[ixRegion];
+	if ( sync == nullptr )
+		return false;
+
+	// Usually it's long done, so check without waiting first
+	GLenum eResult = glClientWaitSync( sync, 0, 0 );
+	bool bStalled = eResult == GL_TIMEOUT_EXPIRED;
+	while ( eResult == GL_TIMEOUT_EXPIRED )
+		eResult = glClientWaitSync( sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000 );
+
+	glDeleteSync( sync );
+	sync = nullptr;
+	return bStalled;
+}
+
+void * RingBuffer::Map( size_t uBytes )
+{
+	if ( uBytes > m_uRegionBytes && allocate( std::max( uBytes, 2 * m_uRegionBytes ) ) == false )
+		return nullptr;
+
+	m_uMappedBytes = uBytes;
+	if ( m_bPersistent == false )
+		return m_vStaging.data();
+
+	if ( waitForRegion( m_ixRegion ) )
+		m_nStalls++;
+
+	return m_pMapped + m_ixRegion * m_uRegionBytes;
+}
+
+size_t RingBuffer::Unmap()
+{
+	// Coherent mapping, so there's nothing to flush
+	if ( m_bPersistent )
+		return m_ixRegion * m_uRegionBytes;
+
+	// Orphan the old storage so the driver hands us fresh memory
+	// instead of waiting for the GPU to finish reading it
+	glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+	glBufferData( GL_ARRAY_BUFFER, m_uRegionBytes, nullptr, GL_STREAM_DRAW );
+	glBufferSubData( GL_ARRAY_BUFFER, 0, m_uMappedBytes, m_vStaging.data() );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	return 0;
+}
+
+void RingBuffer::Fence()
+{
+	if ( m_bPersistent == false )
+		return;
+
+	m_aFences[m_ixRegion] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	m_ixRegion = (m_ixRegion + 1) % kNumRegions;
+}
+
+GLuint RingBuffer::GetBuffer() const
+{
+	return m_Buffer;
+}
+
+bool RingBuffer::GetIsPersistent() const
+{
+	return m_bPersistent;
+}
+
+int RingBuffer::GetNumStalls() const
+{
+	return m_nStalls;
+}
\ No newline at end of file
@@ -1,21 +1,55 @@
 #include "Scene.h"
 #include "Util.h"
 #include "CollisionFunctions.h"
+#include "ContactKernels.h"
 
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/common.hpp>
 #include <algorithm>
+#include <cstddef>
 
 
 Scene::Scene() :
 	m_bQuitFlag( false ),
+	m_bHeadless( false ),
 	m_bDrawContacts( false ),
 	m_bPauseCollision( false ),
+	m_eBroadphase( EBroadphase::SortAndSweep ),
+	m_eSolver( ESolver::Serial ),
+	m_bBatchNarrowphase( true ),
+	m_bBucketNarrowphase( false ),
+	m_bSIMDIntegrate( false ),
+	m_fPlaneMargin( 0.1f ),
+	m_nPlaneContacts( 0 ),
+	m_bCullContacts( true ),
+	m_fCullMargin( 0.1f ),
+	m_nCulled( 0 ),
+	m_fTimeStep( g_fTimeStep ),
+	m_nMaxSubsteps( 8 ),
+	m_bRealTime( true ),
+	m_bInterpolate( true ),
+	m_bFirstUpdate( true ),
+	m_fAccumulator( 0 ),
+	m_fInterpAlpha( 1 ),
+	m_nLastSubsteps( 0 ),
+	m_v2Gravity( 0 ),
+	m_fWarmStartFactor( 0.8f ),
+	m_bSleepEnabled( true ),
+	m_fSleepEnergy( 0.5f ),
+	m_fTimeToSleep( 0.5f ),
+	m_nSlept( 0 ),
+	m_nWoken( 0 ),
+	m_bInstancedDraw( true ),
+	m_bCanInstance( false ),
+	m_nDrawCalls( 0 ),
 	m_GLContext( nullptr ),
 	m_pWindow( nullptr )
 {}
 
 Scene::~Scene()
 {
+	if ( m_GLContext )
+		m_InstanceRing.Destroy();
 	if ( m_pWindow )
 	{
 		SDL_DestroyWindow( m_pWindow );
@@ -30,35 +64,63 @@ Scene::~Scene()
 
 void Scene::Draw()
 {
+	// Nothing to draw to
+	if ( m_bHeadless )
+		return;
+
 	// Clear the screen
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-	// Bind the shader
-	auto sBind = m_Shader.ScopeBind();
-
-	// Get the camera mat as well as some handles
-	GLuint pmvHandle = m_Shader.GetHandle( "u_PMV" );
-	GLuint clrHandle = m_Shader.GetHandle( "u_Color" );
 	mat4 P = m_Camera.GetCameraMat();
+	m_nDrawCalls = 0;
 
-	// Draw every Drawable
-	for ( Drawable& dr : m_vDrawables )
+	// Drawables bound to a rigid body get drawn
+	// between the body's last two positions
+	const bool bInterpolate = m_bInterpolate && m_vPrevPositions.size() == m_vRigidBodies.size();
+	if ( bInterpolate )
 	{
-		if ( dr.GetIsActive() == false )
-			continue;
+		m_vBodyOfDrawable.assign( m_vDrawables.size(), -1 );
+		for ( const DrawableBinding& binding : m_vDrawableBindings )
+			if ( binding.bSoft == false )
+				m_vBodyOfDrawable[binding.uDrawable] = (int) binding.uBody;
+	}
+
+	// Transforms and colors go through the instance ring if we can,
+	// with one draw call per mesh, or per drawable if that's off
+	if ( m_bCanInstance )
+	{
+		auto sInstBind = m_InstShader.ScopeBind();
+		drawInstanced( P, bInterpolate, m_bInstancedDraw );
+	}
+
+	// Bind the shader and get some handles
+	auto sBind = m_Shader.ScopeBind();
+	GLint pmvHandle = m_Shader.GetHandle( Shader::EHandle::PMV );
+	GLint clrHandle = m_Shader.GetHandle( Shader::EHandle::Color );
+
+	// Otherwise draw every Drawable on its own
+	if ( m_bCanInstance == false )
+	{
+		for ( size_t i = 0; i < m_vDrawables.size(); i++ )
+		{
+			Drawable& dr = m_vDrawables[i];
+			if ( dr.GetIsActive() == false )
+				continue;
 
-		mat4 PMV = P * dr.GetMV();
-		vec4 c = dr.GetColor();
-		glUniformMatrix4fv( pmvHandle, 1, GL_FALSE, glm::value_ptr( PMV ) );
-		glUniform4fv( clrHandle, 1, glm::value_ptr( c ) );
-		dr.Draw();
+			mat4 PMV = P * getDrawableMV( i, bInterpolate );
+			vec4 c = dr.GetColor();
+			glUniformMatrix4fv( pmvHandle, 1, GL_FALSE, glm::value_ptr( PMV ) );
+			glUniform4fv( clrHandle, 1, glm::value_ptr( c ) );
+			dr.Draw();
+			m_nDrawCalls++;
+		}
 	}
 
 	if ( m_bDrawContacts )
 	{
 		Drawable d1, d2;
 		std::array<Drawable *, 2> pContactDr = { &d1, &d2 };
-		for ( Contact& c : m_liSpeculativeContacts )
+		for ( Contact& c : m_vSpeculativeContacts )
 		{
 			// NYI
 			c.InitDrawable( pContactDr );
@@ -69,6 +131,7 @@ void Scene::Draw()
 				glUniformMatrix4fv( pmvHandle, 1, GL_FALSE, glm::value_ptr( PMV ) );
 				glUniform4fv( clrHandle, 1, glm::value_ptr( c ) );
 				pDr->Draw();
+				m_nDrawCalls++;
 			}
 		}
 	}
@@ -77,94 +140,735 @@ void Scene::Draw()
 	SDL_GL_SwapWindow( m_pWindow );
 }
 
+// Runs as many fixed steps as the time since the last call covers (or
+// exactly one, if real time is off), but no more than the substep cap.
+// Whatever time is left over decides how far Draw interpolates
 void Scene::Update()
 {
-	// If we haven't paused the RB simulation)
-	if ( m_bPauseCollision == false )
+	// Events are one diff of the last step this update runs against the
+	// last step of the one before, so contacts that start and end
+	// between substeps don't show up
+	m_vCollisionEvents.clear();
+
+	Time::time_point tNow = Time::now();
+	float fElapsed = m_bFirstUpdate ? m_fTimeStep : std::chrono::duration<float>( tNow - m_tLastUpdate ).count();
+	m_tLastUpdate = tNow;
+	m_bFirstUpdate = false;
+
+	m_nLastSubsteps = 0;
+	if ( m_bPauseCollision )
 	{
-		m_liSpeculativeContacts.clear();
+		// Soft bodies can still get moved around
+		syncDrawables();
+		m_fAccumulator = 0;
+		m_fInterpAlpha = 1;
+		return;
+	}
 
-		// Reset the contact list and find contacts
-		int nCollisions( 0 );
-		float fTotalEnergy( 0.f );
+	m_fAccumulator = m_bRealTime ? m_fAccumulator + fElapsed : m_fTimeStep;
+	int nSteps = (int) (m_fAccumulator / m_fTimeStep);
 
-		// Integrate objects
-		for ( RigidBody2D& rb : m_vRigidBodies )
-			if ( rb.GetIsActive() )
-				rb.Integrate( g_fTimeStep );
+	// If we can't keep up, let the simulation slow down rather than
+	// falling further behind every frame
+	if ( nSteps > m_nMaxSubsteps )
+	{
+		nSteps = m_nMaxSubsteps;
+		m_fAccumulator = nSteps * m_fTimeStep;
+	}
+	m_fAccumulator -= nSteps * m_fTimeStep;
+
+	runSteps( nSteps );
+	m_nLastSubsteps = nSteps;
+	m_fInterpAlpha = m_fAccumulator / m_fTimeStep;
+}
 
-		// Get out if there's less than 2
-		if ( m_vRigidBodies.size() < 2 )
-			return;
+// Advance exactly nSteps, whatever the clock says. Meant for running
+// lots of steps (or headless simulations) without coming back out
+void Scene::Step( int nSteps )
+{
+	m_vCollisionEvents.clear();
+	if ( nSteps <= 0 )
+		return;
+
+	runSteps( nSteps );
+	m_nLastSubsteps = nSteps;
+	m_fInterpAlpha = 1;
+}
+
+// Forces get applied once a frame (or Step call), but every step
+// should feel them. Running no steps drops them like a step would have
+void Scene::runSteps( int nSteps )
+{
+	m_vFrameForces.resize( m_vRigidBodies.size() );
+	for ( size_t i = 0; i < m_vRigidBodies.size(); i++ )
+	{
+		m_vFrameForces[i] = m_vRigidBodies[i].v2Force;
+		if ( nSteps == 0 )
+			m_vRigidBodies[i].v2Force = vec2();
+	}
 
-		// Plane on rb
-		for ( Plane& P : m_vCollisionPlanes )
+	// Keep the bank as of the last frame, for events
+	if ( nSteps > 0 )
+		std::swap( m_CollisionBank, m_PrevCollisionBank );
+
+	for ( int s = 0; s < nSteps; s++ )
+	{
+		// Each step gets the bank from the step before it
+		if ( s > 0 )
+		{
+			std::swap( m_CollisionBank, m_LastStepBank );
+			for ( size_t i = 0; i < m_vRigidBodies.size(); i++ )
+				m_vRigidBodies[i].v2Force = m_vFrameForces[i];
+		}
+
+		m_vPrevPositions.resize( m_vRigidBodies.size() );
+		for ( size_t i = 0; i < m_vRigidBodies.size(); i++ )
+			m_vPrevPositions[i] = m_vRigidBodies[i].v2Center;
+
+		step( s == 0 ? m_PrevCollisionBank : m_LastStepBank );
+	}
+
+	// What changed over the whole frame
+	if ( nSteps > 0 )
+		m_CollisionBank.Diff( m_PrevCollisionBank, m_vCollisionEvents );
+
+	syncDrawables();
+}
+
+// One physics step of m_fTimeStep. lastBank is the collision bank
+// from the step before, which pairs nothing moved in carry over
+void Scene::step( const CollisionBank& lastBank )
+{
+	m_vSpeculativeContacts.clear();
+	m_vIslandLinks.clear();
+
+	// The bank only reflects this step
+	m_CollisionBank.Clear();
+
+	// Reset the contact list and find contacts
+	int nCollisions( 0 );
+	float fTotalEnergy( 0.f );
+
+	// Gravity and attractors go on top of whatever Python applied
+	applyForceField();
+
+	// Sleepers stay put unless their force changes
+	wakeForcedBodies();
+
+	// Integrate, refreshing the SoA copy the contact kernels read
+	if ( m_bSIMDIntegrate )
+		m_BodyStore.IntegrateSIMD( m_vRigidBodies, m_fTimeStep );
+	else
+		m_BodyStore.Integrate( m_vRigidBodies, m_fTimeStep );
+
+	// Get out if there's less than 2
+	if ( m_vRigidBodies.size() < 2 )
+		return;
+
+	// Plane on rb. Planes can't push immovable or sleeping bodies
+	// around, and only bodies that could get to one this step (give
+	// or take the margin) get a contact with it
+	m_nPlaneContacts = 0;
+	m_vPlaneCandidates.resize( m_BodyStore.Size() );
+	for ( Plane& P : m_vCollisionPlanes )
+	{
+		if ( P.GetIsActive() == false )
+			continue;
+
+		size_t nCandidates = GetPlaneCandidates( m_BodyStore, P, m_fTimeStep, m_fPlaneMargin, m_vPlaneCandidates.data() );
+		for ( size_t i = 0; i < nCandidates; i++ )
 		{
-			if ( P.GetIsActive() == false )
+			RigidBody2D& RB = m_vRigidBodies[m_vPlaneCandidates[i]];
+			m_vSpeculativeContacts.push_back( GetSpeculativeContact( &P, &RB ) );
+			m_vSpeculativeContacts.back().SetCacheKey( ContactCache::MakePlaneKey(
+				(uint32_t) (&P - m_vCollisionPlanes.data()), m_vPlaneCandidates[i] ) );
+		}
+		m_nPlaneContacts += (int) nCandidates;
+	}
+
+	// Let the broadphase find pairs whose swept bounds overlap
+	const std::vector<BodyPair> * pvPairs = nullptr;
+	if ( m_eBroadphase == EBroadphase::UniformGrid )
+	{
+		m_SpatialHash.Update( m_vRigidBodies, m_vSoftBodies, m_fTimeStep );
+		pvPairs = &m_SpatialHash.GetPairs();
+	}
+	else
+	{
+		m_SortAndSweep.Update( m_vRigidBodies, m_fTimeStep );
+		pvPairs = &m_SortAndSweep.GetPairs();
+	}
+
+	// Narrowphase, a contiguous run of pairs per thread
+	const std::vector<BodyPair>& vPairs = *pvPairs;
+	m_vNarrowphaseChunks.resize( std::max<size_t>( 1, m_JobPool.GetNumChunks( vPairs.size() ) ) );
+	m_JobPool.ParallelFor( vPairs.size(), [this, &vPairs] ( size_t uChunk, size_t uBegin, size_t uEnd )
+	{
+		NarrowphaseChunk& chunk = m_vNarrowphaseChunks[uChunk];
+		chunk.vContacts.clear();
+		chunk.vIslandLinks.clear();
+		chunk.vHeldPairs.clear();
+		chunk.vCirclePairs.clear();
+		chunk.vCircleSlots.clear();
+		chunk.vBoxPairs.clear();
+		chunk.vBoxSlots.clear();
+		chunk.vBucketPairs.clear();
+
+		for ( size_t i = uBegin; i < uEnd; i++ )
+		{
+			const BodyPair& bp = vPairs[i];
+			RigidBody2D * pA = &m_vRigidBodies[bp.first];
+			RigidBody2D * pB = &m_vRigidBodies[bp.second];
+
+			// Skip unless one of them can actually move
+			bool bMovesA = pA->fInvMass > 0 && pA->bAsleep == false;
+			bool bMovesB = pB->fInvMass > 0 && pB->bAsleep == false;
+			if ( bMovesA == false && bMovesB == false )
+			{
+				// Two sleepers touching still belong to the same island
+				if ( pA->bAsleep && pB->bAsleep )
+					chunk.vIslandLinks.push_back( bp );
+
+				// Sleeping isn't a change in contact, so these keep their state
+				if ( pA->bAsleep || pB->bAsleep )
+					chunk.vHeldPairs.push_back( bp );
 				continue;
+			}
 
-			for ( RigidBody2D& RB : m_vRigidBodies )
+			// Sorted and done all at once after the merge
+			if ( m_bBucketNarrowphase )
 			{
-				if ( RB.GetIsActive() == false )
-					continue;
+				chunk.vBucketPairs.push_back( bp );
+				continue;
+			}
 
-				m_liSpeculativeContacts.push_back( GetSpeculativeContact( &P, &RB ) );
+			// Circle and box pairs get done in bulk below, hold their spot
+			if ( m_bBatchNarrowphase && pA->eType == pB->eType )
+			{
+				if ( pA->eType == Shape::EType::Circle )
+				{
+					chunk.vCirclePairs.push_back( bp );
+					chunk.vCircleSlots.push_back( (uint32_t) chunk.vContacts.size() );
+					chunk.vContacts.emplace_back();
+					continue;
+				}
+				if ( pA->eType == Shape::EType::AABB )
+				{
+					chunk.vBoxPairs.push_back( bp );
+					chunk.vBoxSlots.push_back( (uint32_t) chunk.vContacts.size() );
+					chunk.vContacts.emplace_back();
+					continue;
+				}
 			}
+
+			chunk.vContacts.push_back( GetSpeculativeContact( pA, pB ) );
+			chunk.vContacts.back().SetCacheKey( ContactCache::MakePairKey( bp.first, bp.second ) );
 		}
 
-		// For every plane
+		// Run the circle kernel and put the results where they'd have gone
+		chunk.vCircleContacts.resize( chunk.vCirclePairs.size() );
+		GetCircleContacts( m_BodyStore, m_vRigidBodies.data(), chunk.vCirclePairs, chunk.vCircleContacts.data() );
+		for ( size_t i = 0; i < chunk.vCirclePairs.size(); i++ )
+		{
+			const BodyPair& bp = chunk.vCirclePairs[i];
+			Contact& c = chunk.vContacts[chunk.vCircleSlots[i]];
+			c = chunk.vCircleContacts[i];
+			c.SetCacheKey( ContactCache::MakePairKey( bp.first, bp.second ) );
+		}
+
+		// Then the box kernel
+		chunk.vBoxContacts.resize( chunk.vBoxPairs.size() );
+		GetBoxContacts( m_BodyStore, m_vRigidBodies.data(), chunk.vBoxPairs, chunk.vBoxContacts.data() );
+		for ( size_t i = 0; i < chunk.vBoxPairs.size(); i++ )
+		{
+			const BodyPair& bp = chunk.vBoxPairs[i];
+			Contact& c = chunk.vContacts[chunk.vBoxSlots[i]];
+			c = chunk.vBoxContacts[i];
+			c.SetCacheKey( ContactCache::MakePairKey( bp.first, bp.second ) );
+		}
+	} );
+
+	// Merge in chunk order, so the contact order is the same as
+	// a serial loop would give no matter how many threads we used
+	m_vBucketPairs.clear();
+	for ( size_t i = 0; i < m_JobPool.GetNumChunks( vPairs.size() ); i++ )
+	{
+		const NarrowphaseChunk& chunk = m_vNarrowphaseChunks[i];
+		m_vSpeculativeContacts.insert( m_vSpeculativeContacts.end(), chunk.vContacts.begin(), chunk.vContacts.end() );
+		m_vIslandLinks.insert( m_vIslandLinks.end(), chunk.vIslandLinks.begin(), chunk.vIslandLinks.end() );
+		m_vBucketPairs.insert( m_vBucketPairs.end(), chunk.vBucketPairs.begin(), chunk.vBucketPairs.end() );
+	}
+
+	// Sorting all the pairs at once keeps that true when bucketing
+	if ( m_bBucketNarrowphase )
+		bucketNarrowphase();
 
-			// For every RB
-		for ( auto itOuter = m_vRigidBodies.begin(); itOuter != m_vRigidBodies.end(); ++itOuter )
+	// Drop contacts too far apart to matter this step
+	cullContacts();
+
+	// Increment total energy while we're at it
+	for ( RigidBody2D& rb : m_vRigidBodies )
+		if ( rb.GetIsActive() )
+			fTotalEnergy += rb.GetKineticEnergy();
+
+	// Soft bodies here? The grid already binned them
+	if ( m_eBroadphase == EBroadphase::UniformGrid )
+	{
+		for ( const BodyPair& sp : m_SpatialHash.GetSoftPairs() )
+		{
+			SoftBody2D * pSB = &m_vSoftBodies[sp.first];
+			RigidBody2D * pRB = &m_vRigidBodies[sp.second];
+			m_CollisionBank.Set( sp.first | kSoftBankKey, sp.second, IsOverlapping( pSB, pRB ) );
+		}
+	}
+	else
+	{
+		// Otherwise ask the soft body tree
+		updateSoftBodyTree();
+		for ( RigidBody2D& rb : m_vRigidBodies )
 		{
-			if ( itOuter->GetIsActive() == false )
+			if ( rb.GetIsActive() == false )
 				continue;
 
-			// Check every one against the other
-			for ( auto itInner = itOuter + 1; itInner != m_vRigidBodies.end(); ++itInner )
+			m_SoftBodyTree.Query( GetBounds( &rb ), [this, &rb] ( uint32_t uSoftIdx )
 			{
-				if ( itInner->GetIsActive() == false )
-					continue;
+				SoftBody2D * pSB = &m_vSoftBodies[uSoftIdx];
+				m_CollisionBank.Set( uSoftIdx | kSoftBankKey, (uint32_t) (&rb - m_vRigidBodies.data()), IsOverlapping( pSB, &rb ) );
+			} );
+		}
+	}
 
-				// Skip if both have negative mass
-				if ( itOuter->fMass < 0 && itInner->fMass < 0 )
-					continue;
+	// The solver and sleeping both work off of these
+	buildIslands();
 
-				m_liSpeculativeContacts.push_back( GetSpeculativeContact( &*itOuter, &*itInner ) );
-			}
+	// Start from last step's impulses, solve, and remember the new ones
+	m_ContactCache.WarmStart( m_vSpeculativeContacts, m_fWarmStartFactor, 1.f / m_fTimeStep );
+	if ( m_eSolver == ESolver::Islands )
+		m_ContactSolver.SolveIslands( m_vSpeculativeContacts, m_vIslandContacts, m_vIslandContactStart, m_JobPool );
+	else
+		m_ContactSolver.Solve( m_vSpeculativeContacts );
+	m_ContactCache.Store( m_vSpeculativeContacts );
 
-			// Increment total energy while we're at it
-			fTotalEnergy += itOuter->GetKineticEnergy();
+	for ( Contact& c : m_vSpeculativeContacts )
+	{
+		if ( c.HasPlane() == false )
+		{
+			m_CollisionBank.Set( (uint32_t) (c.GetBodyA() - m_vRigidBodies.data()),
+								 (uint32_t) (c.GetBodyB() - m_vRigidBodies.data()), c.IsColliding() );
+		}
+	}
+
+	// Pairs skipped because a sleeper was in them and neither
+	// could move stay as they were, so a resting stack falling
+	// asleep (or waking) doesn't end and begin its contacts
+	for ( size_t i = 0; i < m_JobPool.GetNumChunks( vPairs.size() ); i++ )
+		for ( const BodyPair& bp : m_vNarrowphaseChunks[i].vHeldPairs )
+			if ( lastBank.Get( bp.first, bp.second ) )
+				m_CollisionBank.Set( bp.first, bp.second, true );
+
+	// Put settled islands to sleep, wake any that got bumped
+	updateSleep();
+}
+
+// A contact only does anything if its bodies close the distance between
+// them within the step, so those that couldn't even with the margin are
+// dropped before the islands and solver see them. Order is kept
+void Scene::cullContacts()
+{
+	m_nCulled = 0;
+	if ( m_bCullContacts == false )
+		return;
 
-			// Soft bodies here?
-			static size_t uOverlaps( 0 );
-			for ( SoftBody2D& sb : m_vSoftBodies )
+	auto itEnd = std::remove_if( m_vSpeculativeContacts.begin(), m_vSpeculativeContacts.end(), [this] ( const Contact& c )
+	{
+		float fClosingSpeed = std::max( 0.f, -c.GetRelVel() );
+		return c.GetDistance() > fClosingSpeed * m_fTimeStep + m_fCullMargin;
+	} );
+
+	m_nCulled = (int) (m_vSpeculativeContacts.end() - itEnd);
+	m_vSpeculativeContacts.erase( itEnd, m_vSpeculativeContacts.end() );
+}
+
+// Sorts every pair by type pair (keeping their order within a pair
+// type) and appends their contacts in that order. Each run is done
+// with one function from the dispatch table, or with a SIMD kernel if
+// there is one for those types. The sort is over all the merged pairs,
+// so the order doesn't depend on the thread count; the contacts are
+// then split across the pool, each one going to a fixed slot
+void Scene::bucketNarrowphase()
+{
+	const int N = Shape::kNumTypes;
+	auto bucketOf = [this] ( const BodyPair& bp )
+	{
+		return (int) m_vRigidBodies[bp.first].eType * N + (int) m_vRigidBodies[bp.second].eType;
+	};
+
+	// Counting sort, aStart[b] is where bucket b begins
+	std::array<uint32_t, N * N + 1> aStart;
+	aStart.fill( 0 );
+	for ( const BodyPair& bp : m_vBucketPairs )
+		aStart[bucketOf( bp ) + 1]++;
+	for ( int b = 0; b < N * N; b++ )
+		aStart[b + 1] += aStart[b];
+
+	std::array<uint32_t, N * N + 1> aCursor = aStart;
+	m_vSortedPairs.resize( m_vBucketPairs.size() );
+	for ( const BodyPair& bp : m_vBucketPairs )
+		m_vSortedPairs[aCursor[bucketOf( bp )]++] = bp;
+
+	const size_t uFirst = m_vSpeculativeContacts.size();
+	m_vSpeculativeContacts.resize( uFirst + m_vSortedPairs.size() );
+	Contact * pOut = m_vSpeculativeContacts.data() + uFirst;
+	m_JobPool.ParallelFor( m_vSortedPairs.size(), [this, &aStart, pOut] ( size_t, size_t uBegin, size_t uEnd )
+	{
+		// Do the part of each bucket that falls in this range
+		for ( int b = 0; b < N * N; b++ )
+		{
+			size_t uLo = std::max<size_t>( aStart[b], uBegin );
+			size_t uHi = std::min<size_t>( aStart[b + 1], uEnd );
+			if ( uLo >= uHi )
+				continue;
+
+			Span<const BodyPair> spBucket( m_vSortedPairs.data() + uLo, m_vSortedPairs.data() + uHi );
+			Shape::EType eA = (Shape::EType) (b / N);
+			Shape::EType eB = (Shape::EType) (b % N);
+			if ( m_bBatchNarrowphase && eA == Shape::EType::Circle && eB == Shape::EType::Circle )
+				GetCircleContacts( m_BodyStore, m_vRigidBodies.data(), spBucket, pOut + uLo );
+			else if ( m_bBatchNarrowphase && eA == Shape::EType::AABB && eB == Shape::EType::AABB )
+				GetBoxContacts( m_BodyStore, m_vRigidBodies.data(), spBucket, pOut + uLo );
+			else
 			{
-				if ( sb.GetIsActive() == false )
-					continue;
+				// Every pair in here has the same types, so look it up once
+				SpecContactFn fnContact = GetSpecContactFn( &m_vRigidBodies[spBucket[0].first], &m_vRigidBodies[spBucket[0].second] );
+				for ( size_t i = 0; i < spBucket.size(); i++ )
+					pOut[uLo + i] = fnContact( &m_vRigidBodies[spBucket[i].first], &m_vRigidBodies[spBucket[i].second] );
+			}
+		}
+
+		for ( size_t i = uBegin; i < uEnd; i++ )
+			pOut[i].SetCacheKey( ContactCache::MakePairKey( m_vSortedPairs[i].first, m_vSortedPairs[i].second ) );
+	} );
+}
+
+// Gravity scales with mass, attractors don't (that's how main.py did it).
+// Sleepers get the same force as usual, so a steady field won't wake them
+void Scene::applyForceField()
+{
+	bool bAnyAttractors = std::any_of( m_vAttractors.begin(), m_vAttractors.end(),
+									   [] ( const Attractor& a ) { return a.bActive; } );
+	if ( m_v2Gravity == vec2() && bAnyAttractors == false )
+		return;
+
+	for ( RigidBody2D& rb : m_vRigidBodies )
+	{
+		if ( rb.GetIsActive() == false || rb.fInvMass == 0 )
+			continue;
+
+		rb.v2Force += rb.fMass * m_v2Gravity;
+		for ( const Attractor& a : m_vAttractors )
+		{
+			if ( a.bActive == false )
+				continue;
+
+			vec2 d = rb.v2Center - a.v2Pos;
+			rb.v2Force -= a.fStrength * d / std::max( a.fMinDist2, glm::dot( d, d ) );
+		}
+	}
+}
+
+// Called before integration. Awake bodies remember the force they're
+// under, sleeping ones get woken if theirs is different (the Python
+// side applies gravity every frame, so a steady force isn't a reason)
+void Scene::wakeForcedBodies()
+{
+	m_nSlept = 0;
+	m_nWoken = 0;
+
+	for ( RigidBody2D& rb : m_vRigidBodies )
+	{
+		if ( rb.bAsleep == false )
+		{
+			rb.v2SleepForce = rb.v2Force;
+			continue;
+		}
+
+		vec2 v2Diff = rb.v2Force - rb.v2SleepForce;
+		if ( m_bSleepEnabled == false || rb.GetIsActive() == false || glm::dot( v2Diff, v2Diff ) > kEPS )
+		{
+			rb.Wake();
+			rb.v2SleepForce = rb.v2Force;
+			m_nWoken++;
+		}
+		else
+		{
+			// The store won't clear it for us
+			rb.v2Force = vec2();
+		}
+	}
+}
 
-				m_CollisionBank[ColPair(&sb, &*itOuter)] = IsOverlapping( &sb, &*itOuter );
+// Islands are bodies joined by contacts, along with sleeping pairs that
+// didn't get a contact. Immovable bodies don't join islands (they never
+// pick up velocity), otherwise everything on the ground would be one
+// big island. Contacts get grouped by island for the island solver
+void Scene::buildIslands()
+{
+	const RigidBody2D * pFirst = m_vRigidBodies.data();
+	m_IslandGraph.Reset( m_vRigidBodies.size() );
+	for ( const BodyPair& bp : m_vIslandLinks )
+		m_IslandGraph.Link( bp.first, bp.second );
+
+	for ( const Contact& c : m_vSpeculativeContacts )
+	{
+		if ( c.HasPlane() )
+			continue;
+
+		const RigidBody2D * pA = c.GetBodyA();
+		const RigidBody2D * pB = c.GetBodyB();
+		if ( pA->fInvMass > 0 && pB->fInvMass > 0 )
+			m_IslandGraph.Link( (uint32_t) (pA - pFirst), (uint32_t) (pB - pFirst) );
+	}
+	m_IslandGraph.Build();
+
+	// A contact belongs to the island of whichever body can move
+	m_vIslandContactCount.assign( m_IslandGraph.GetNumIslands(), 0 );
+	m_vContactIsland.resize( m_vSpeculativeContacts.size() );
+	for ( size_t i = 0; i < m_vSpeculativeContacts.size(); i++ )
+	{
+		const Contact& c = m_vSpeculativeContacts[i];
+		const RigidBody2D * pRB = c.HasPlane() || c.GetBodyA()->fInvMass == 0 ? c.GetBodyB() : c.GetBodyA();
+		m_vContactIsland[i] = m_IslandGraph.GetIsland( (uint32_t) (pRB - pFirst) );
+		m_vIslandContactCount[m_vContactIsland[i]]++;
+	}
+
+	// Islands without contacts have nothing to solve, so they're left
+	// out. The counts become each island's write cursor into the order
+	m_vIslandContactStart.assign( 1, 0 );
+	for ( uint32_t& uCount : m_vIslandContactCount )
+	{
+		uint32_t uStart = m_vIslandContactStart.back();
+		if ( uCount > 0 )
+			m_vIslandContactStart.push_back( uStart + uCount );
+		uCount = uStart;
+	}
+
+	m_vIslandContacts.resize( m_vSpeculativeContacts.size() );
+	for ( uint32_t i = 0; i < (uint32_t) m_vSpeculativeContacts.size(); i++ )
+		m_vIslandContacts[m_vIslandContactCount[m_vContactIsland[i]]++] = i;
+}
+
+// An island goes to sleep once every body in it has been below the
+// energy threshold for a while, and wakes up entirely if any is awake
+void Scene::updateSleep()
+{
+	if ( m_bSleepEnabled == false )
+		return;
+
+	for ( size_t i = 0; i < m_IslandGraph.GetNumIslands(); i++ )
+	{
+		bool bAnyAwake = false;
+		bool bAllRested = true;
+		for ( uint32_t uBody : m_IslandGraph.GetIslandBodies( i ) )
+		{
+			RigidBody2D& rb = m_vRigidBodies[uBody];
+			if ( rb.GetIsActive() == false || rb.fInvMass == 0 )
+				continue;
+
+			if ( rb.bAsleep == false )
+			{
+				bAnyAwake = true;
+				if ( rb.GetKineticEnergy() < m_fSleepEnergy )
+					rb.fRestTime += m_fTimeStep;
+				else
+					rb.fRestTime = 0;
 			}
+
+			bAllRested = bAllRested && rb.fRestTime >= m_fTimeToSleep;
 		}
-		
-		
 
-		// Solve contacts
-		m_ContactSolver.Solve( m_liSpeculativeContacts );
+		// Nothing to change if it's all asleep or all awake and busy
+		if ( bAnyAwake == false )
+			continue;
 
-		for ( Contact& c : m_liSpeculativeContacts )
+		for ( uint32_t uBody : m_IslandGraph.GetIslandBodies( i ) )
 		{
-			if ( c.HasPlane() == false )
+			RigidBody2D& rb = m_vRigidBodies[uBody];
+			if ( rb.GetIsActive() == false || rb.fInvMass == 0 )
+				continue;
+
+			if ( bAllRested && rb.bAsleep == false )
+			{
+				rb.bAsleep = true;
+				rb.v2Vel = vec2();
+				m_nSlept++;
+			}
+			else if ( bAllRested == false && rb.bAsleep )
 			{
-				m_CollisionBank[ColPair((Shape *)c.GetBodyA(), (Shape *) c.GetBodyB())] = c.IsColliding();
+				rb.Wake();
+				m_nWoken++;
 			}
 		}
 	}
 }
 
+// Keep the tree in sync with the soft bodies. Only bodies
+// that were activated, deactivated or moved get touched
+void Scene::updateSoftBodyTree()
+{
+	for ( size_t i = 0; i < m_vSoftBodies.size(); i++ )
+	{
+		SoftBody2D& sb = m_vSoftBodies[i];
+		int& iProxy = m_vSoftBodyProxies[i];
+		if ( sb.GetIsActive() )
+		{
+			if ( iProxy < 0 )
+				iProxy = m_SoftBodyTree.CreateProxy( GetBounds( &sb ), (uint32_t) i );
+			else if ( sb.bMoved )
+				m_SoftBodyTree.MoveProxy( iProxy, GetBounds( &sb ) );
+		}
+		else if ( iProxy >= 0 )
+		{
+			m_SoftBodyTree.DestroyProxy( iProxy );
+			iProxy = -1;
+		}
+
+		sb.bMoved = false;
+	}
+}
+
+// One pass over the bindings instead of a trip through Python per
+// entity. Drawables whose body didn't move keep their cached MV
+void Scene::syncDrawables()
+{
+	for ( const DrawableBinding& binding : m_vDrawableBindings )
+	{
+		const Shape& body = binding.bSoft ? m_vSoftBodies[binding.uBody] : m_vRigidBodies[binding.uBody];
+		Drawable& dr = m_vDrawables[binding.uDrawable];
+		if ( dr.GetPos() != vec3( body.v2Center, 0 ) )
+			dr.SetPos2D( body.v2Center );
+	}
+}
+
+// A drawable's MV, interpolated if it's bound to a rigid body
+mat4 Scene::getDrawableMV( size_t ixDrawable, bool bInterpolate ) const
+{
+	const Drawable& dr = m_vDrawables[ixDrawable];
+	if ( bInterpolate && m_vBodyOfDrawable[ixDrawable] >= 0 )
+	{
+		int iBody = m_vBodyOfDrawable[ixDrawable];
+		return dr.GetMV( glm::mix( m_vPrevPositions[iBody], m_vRigidBodies[iBody].v2Center, m_fInterpAlpha ) );
+	}
+
+	return dr.GetMV();
+}
+
+// Group active drawables by VAO, write their transforms and colors
+// straight into the instance ring in group order, then draw each
+// group at once. Without bGroupByMesh every drawable is its own group
+void Scene::drawInstanced( const mat4& P, bool bInterpolate, bool bGroupByMesh )
+{
+	// There are only a few meshes, so find groups with a linear search
+	m_vInstanceGroups.clear();
+	m_vInstanceGroupOf.resize( m_vDrawables.size() );
+	for ( size_t i = 0; i < m_vDrawables.size(); i++ )
+	{
+		const Drawable& dr = m_vDrawables[i];
+		if ( dr.GetIsActive() == false )
+			continue;
+
+		uint32_t ixGroup = bGroupByMesh ? 0 : (uint32_t) m_vInstanceGroups.size();
+		while ( ixGroup < m_vInstanceGroups.size() && m_vInstanceGroups[ixGroup].pDrawable->GetVAO() != dr.GetVAO() )
+			ixGroup++;
+		if ( ixGroup == m_vInstanceGroups.size() )
+			m_vInstanceGroups.push_back( { &dr, 0, 0 } );
+
+		m_vInstanceGroups[ixGroup].uCount++;
+		m_vInstanceGroupOf[i] = ixGroup;
+	}
+
+	// Counts become offsets, then fill in each group's run
+	uint32_t uTotal = 0;
+	for ( InstanceGroup& group : m_vInstanceGroups )
+	{
+		group.uOffset = uTotal;
+		uTotal += group.uCount;
+		group.uCount = 0;
+	}
+
+	if ( uTotal == 0 )
+		return;
+
+	InstanceData * pInstances = (InstanceData *) m_InstanceRing.Map( uTotal * sizeof( InstanceData ) );
+	if ( pInstances == nullptr )
+		return;
+
+	for ( size_t i = 0; i < m_vDrawables.size(); i++ )
+	{
+		const Drawable& dr = m_vDrawables[i];
+		if ( dr.GetIsActive() == false )
+			continue;
+
+		InstanceGroup& group = m_vInstanceGroups[m_vInstanceGroupOf[i]];
+		pInstances[group.uOffset + group.uCount++] = { getDrawableMV( i, bInterpolate ), dr.GetColor() };
+	}
+
+	size_t uBase = m_InstanceRing.Unmap();
+	glBindBuffer( GL_ARRAY_BUFFER, m_InstanceRing.GetBuffer() );
+
+	glUniformMatrix4fv( m_InstShader.GetHandle( Shader::EHandle::CamMat ), 1, GL_FALSE, glm::value_ptr( P ) );
+	for ( const InstanceGroup& group : m_vInstanceGroups )
+	{
+		// The VAO remembers the attrib pointers, so point them at this group's run
+		glBindVertexArray( group.pDrawable->GetVAO() );
+		bindInstanceAttribs( uBase + group.uOffset * sizeof( InstanceData ) );
+		group.pDrawable->DrawInstanced( group.uCount );
+		m_nDrawCalls++;
+	}
+
+	glBindVertexArray( 0 );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	// The region can be reused once these draws are done
+	m_InstanceRing.Fence();
+}
+
+// Divisors are core in 3.3, before that they come from ARB_instanced_arrays
+static void setAttribDivisor( GLuint uLoc, GLuint uDivisor )
+{
+	if ( GLEW_VERSION_3_3 )
+		glVertexAttribDivisor( uLoc, uDivisor );
+	else
+		glVertexAttribDivisorARB( uLoc, uDivisor );
+}
+
+// Point the bound VAO's instance attributes at the instance
+// buffer, starting uOffset bytes in. A mat4 attribute takes
+// four locations, one per column
+void Scene::bindInstanceAttribs( size_t uOffset )
+{
+	const GLsizei nStride = sizeof( InstanceData );
+	const GLint hMV = m_InstShader.GetHandle( Shader::EHandle::MV );
+	const GLint hColor = m_InstShader.GetHandle( Shader::EHandle::InstColor );
+	for ( GLint c = 0; c < 4; c++ )
+	{
+		GLuint uLoc = hMV + c;
+		glEnableVertexAttribArray( uLoc );
+		glVertexAttribPointer( uLoc, 4, GL_FLOAT, GL_FALSE, nStride, (const GLvoid *) (uOffset + offsetof( InstanceData, m4MV ) + c * sizeof( vec4 )) );
+		setAttribDivisor( uLoc, 1 );
+	}
+
+	glEnableVertexAttribArray( hColor );
+	glVertexAttribPointer( hColor, 4, GL_FLOAT, GL_FALSE, nStride, (const GLvoid *) (uOffset + offsetof( InstanceData, v4Color )) );
+	setAttribDivisor( hColor, 1 );
+}
+
 // Add a drawable from an IQM file
 int Scene::AddDrawableIQM( std::string strIqmFile, vec2 T, vec2 S, vec4 C, float theta /*= 0.f*/ )
 {
+	// Drawables need a GL context
+	if ( m_bHeadless )
+		return -1;
+
 	Drawable D;
 	try
 	{
@@ -184,6 +888,9 @@ int Scene::AddDrawableIQM( std::string strIqmFile, vec2 T, vec2 S, vec4 C, float
 // Add a drawable from three triangle verts
 int Scene::AddDrawableTri( std::string strName, std::array<vec3, 3> triVerts, vec2 T, vec2 S, vec4 C, float theta /*= 0.f*/ )
 {
+	if ( m_bHeadless )
+		return -1;
+
 	Drawable D;
 	try
 	{
@@ -234,6 +941,7 @@ int Scene::AddSoftBody( Shape::EType eType, glm::vec2 v2Pos, std::map<std::strin
 		}
 
 		m_vSoftBodies.push_back( sb );
+		m_vSoftBodyProxies.push_back( -1 );
 		return m_vSoftBodies.size() - 1;
 	}
 	catch ( std::out_of_range )
@@ -286,6 +994,9 @@ int Scene::AddCollisionPlane( glm::vec2 N, float d )
 	m_vCollisionPlanes.push_back( { true, N, d } );
 	
 	// This function will add the drawable for now
+	if ( m_bHeadless )
+		return (int) (m_vCollisionPlanes.size() - 1);
+
 	const float fLarge = 1000.f;
 	vec2 S( fLarge );
 	vec2 T = (d - fLarge / 2) * N;
@@ -341,12 +1052,19 @@ const RigidBody2D * Scene::GetRigidBody2D( const size_t rbIdx ) const
 	return nullptr;
 }
 
-std::list<Contact *> Scene::GetContacts() const
+// Python wants pointers, C++ should use the span
+std::vector<Contact *> Scene::GetContacts()
+{
+	std::vector<Contact *> vRet;
+	vRet.reserve( m_vSpeculativeContacts.size() );
+	for ( Contact& c : m_vSpeculativeContacts )
+		vRet.push_back( &c );
+	return vRet;
+}
+
+Span<const Contact> Scene::GetContactSpan() const
 {
-	std::list<Contact *> liRet;
-	for ( const Contact& c : m_liSpeculativeContacts )
-		liRet.push_back( (Contact *)&c );
-	return liRet;
+	return Span<const Contact>( m_vSpeculativeContacts );
 }
 
 void Scene::SetQuitFlag( bool bQuit )
@@ -374,21 +1092,143 @@ void Scene::SetDrawContacts( bool bDrawContacts )
 	m_bDrawContacts = bDrawContacts;
 }
 
-//size_t ColPair_hash::operator() ( const ColPair v ) const
-//{
-//	size_t h1 = (size_t) v.first;
-//	size_t h2 = (size_t) v.second;
-//	return h1 ^ h2;
-//}
+// The bank knows bodies by handle, soft ones with the top bit set.
+// Anything that isn't one of ours gets a key nothing is stored under
+uint32_t Scene::getBankKey( const Shape * pShape ) const
+{
+	const RigidBody2D * pRB = (const RigidBody2D *) pShape;
+	if ( pRB >= m_vRigidBodies.data() && pRB < m_vRigidBodies.data() + m_vRigidBodies.size() )
+		return (uint32_t) (pRB - m_vRigidBodies.data());
+
+	const SoftBody2D * pSB = (const SoftBody2D *) pShape;
+	if ( pSB >= m_vSoftBodies.data() && pSB < m_vSoftBodies.data() + m_vSoftBodies.size() )
+		return (uint32_t) (pSB - m_vSoftBodies.data()) | kSoftBankKey;
+
+	return ~0u;
+}
 
 bool Scene::GetIsColliding( Shape * pA, Shape * pB ) const
 {
-	auto it = m_CollisionBank.find( ColPair( pA, pB ) );
-	if ( it == m_CollisionBank.end() )
+	return m_CollisionBank.Get( getBankKey( pA ), getBankKey( pB ) );
+}
+
+Span<const CollisionEvent> Scene::GetCollisionEventSpan() const
+{
+	return m_vCollisionEvents;
+}
+
+// Python gets them flattened, see the header
+std::vector<int> Scene::GetCollisionEvents() const
+{
+	std::vector<int> vRet;
+	vRet.reserve( 4 * m_vCollisionEvents.size() );
+	for ( const CollisionEvent& e : m_vCollisionEvents )
 	{
-		return false;
+		// Soft keys have the top bit, so they're always second
+		vRet.push_back( (int) e.eType );
+		vRet.push_back( (int) e.uKeyA );
+		vRet.push_back( (int) (e.uKeyB & ~kSoftBankKey) );
+		vRet.push_back( (e.uKeyB & kSoftBankKey) ? 1 : 0 );
 	}
-	return it->second;
+	return vRet;
+}
+
+void Scene::SetGravity( vec2 v2Gravity )
+{
+	m_v2Gravity = v2Gravity;
+}
+
+vec2 Scene::GetGravity() const
+{
+	return m_v2Gravity;
+}
+
+int Scene::AddAttractor( vec2 v2Pos, float fStrength, float fMinDist2 )
+{
+	m_vAttractors.push_back( { true, v2Pos, fStrength, fMinDist2 } );
+	return (int) (m_vAttractors.size() - 1);
+}
+
+void Scene::SetAttractorPos( int ixAttractor, vec2 v2Pos )
+{
+	if ( ixAttractor >= 0 && ixAttractor < (int) m_vAttractors.size() )
+		m_vAttractors[ixAttractor].v2Pos = v2Pos;
+}
+
+void Scene::SetAttractorActive( int ixAttractor, bool bActive )
+{
+	if ( ixAttractor >= 0 && ixAttractor < (int) m_vAttractors.size() )
+		m_vAttractors[ixAttractor].bActive = bActive;
+}
+
+void Scene::ClearAttractors()
+{
+	m_vAttractors.clear();
+}
+
+void Scene::SetHeadless( bool bHeadless )
+{
+	m_bHeadless = bHeadless;
+}
+
+bool Scene::GetHeadless() const
+{
+	return m_bHeadless;
+}
+
+void Scene::SetTimeStep( float fDT )
+{
+	if ( fDT <= 0 )
+		return;
+
+	m_fTimeStep = fDT;
+	m_ContactSolver.SetTimeStep( fDT );
+}
+
+float Scene::GetTimeStep() const
+{
+	return m_fTimeStep;
+}
+
+void Scene::SetMaxSubsteps( int nMaxSubsteps )
+{
+	m_nMaxSubsteps = std::max( 1, nMaxSubsteps );
+}
+
+int Scene::GetMaxSubsteps() const
+{
+	return m_nMaxSubsteps;
+}
+
+void Scene::SetRealTime( bool bRealTime )
+{
+	m_bRealTime = bRealTime;
+	m_fAccumulator = 0;
+}
+
+bool Scene::GetRealTime() const
+{
+	return m_bRealTime;
+}
+
+void Scene::SetInterpolate( bool bInterpolate )
+{
+	m_bInterpolate = bInterpolate;
+}
+
+bool Scene::GetInterpolate() const
+{
+	return m_bInterpolate;
+}
+
+int Scene::GetLastSubsteps() const
+{
+	return m_nLastSubsteps;
+}
+
+float Scene::GetInterpAlpha() const
+{
+	return m_fInterpAlpha;
 }
 
 bool Scene::GetDrawContacts() const
@@ -396,8 +1236,314 @@ bool Scene::GetDrawContacts() const
 	return m_bDrawContacts;
 }
 
+void Scene::SetBroadphase( EBroadphase eBroadphase )
+{
+	m_eBroadphase = eBroadphase;
+}
+
+Scene::EBroadphase Scene::GetBroadphase() const
+{
+	return m_eBroadphase;
+}
+
+void Scene::SetSolverIterations( int nIterations )
+{
+	m_ContactSolver.SetIterations( (uint32_t) std::max( 1, nIterations ) );
+}
+
+int Scene::GetSolverIterations() const
+{
+	return (int) m_ContactSolver.GetIterations();
+}
+
+int Scene::GetLastSolverIterations() const
+{
+	return (int) m_ContactSolver.GetLastIterations();
+}
+
+void Scene::SetWarmStartFactor( float fFactor )
+{
+	m_fWarmStartFactor = std::min( std::max( fFactor, 0.f ), 1.f );
+}
+
+float Scene::GetWarmStartFactor() const
+{
+	return m_fWarmStartFactor;
+}
+
+int Scene::GetNumWarmStarted() const
+{
+	return (int) m_ContactCache.GetNumWarmStarted();
+}
+
+void Scene::SetSleepEnabled( bool bSleepEnabled )
+{
+	m_bSleepEnabled = bSleepEnabled;
+}
+
+bool Scene::GetSleepEnabled() const
+{
+	return m_bSleepEnabled;
+}
+
+void Scene::SetSleepEnergy( float fEnergy )
+{
+	m_fSleepEnergy = fEnergy;
+}
+
+void Scene::SetTimeToSleep( float fSeconds )
+{
+	m_fTimeToSleep = fSeconds;
+}
+
+int Scene::GetNumAsleep() const
+{
+	return (int) std::count_if( m_vRigidBodies.begin(), m_vRigidBodies.end(),
+								[] ( const RigidBody2D& rb ) { return rb.bAsleep; } );
+}
+
+int Scene::GetNumSlept() const
+{
+	return m_nSlept;
+}
+
+int Scene::GetNumWoken() const
+{
+	return m_nWoken;
+}
+
+bool Scene::BindRigidBodyDrawable( int ixRigidBody, int ixDrawable )
+{
+	if ( ixRigidBody < 0 || ixRigidBody >= (int) m_vRigidBodies.size() )
+		return false;
+	if ( ixDrawable < 0 || ixDrawable >= (int) m_vDrawables.size() )
+		return false;
+
+	UnbindDrawable( ixDrawable );
+	m_vDrawableBindings.push_back( { (uint32_t) ixRigidBody, (uint32_t) ixDrawable, false } );
+	return true;
+}
+
+bool Scene::BindSoftBodyDrawable( int ixSoftBody, int ixDrawable )
+{
+	if ( ixSoftBody < 0 || ixSoftBody >= (int) m_vSoftBodies.size() )
+		return false;
+	if ( ixDrawable < 0 || ixDrawable >= (int) m_vDrawables.size() )
+		return false;
+
+	UnbindDrawable( ixDrawable );
+	m_vDrawableBindings.push_back( { (uint32_t) ixSoftBody, (uint32_t) ixDrawable, true } );
+	return true;
+}
+
+void Scene::UnbindDrawable( int ixDrawable )
+{
+	m_vDrawableBindings.erase( std::remove_if( m_vDrawableBindings.begin(), m_vDrawableBindings.end(),
+											   [ixDrawable] ( const DrawableBinding& binding ) { return (int) binding.uDrawable == ixDrawable; } ),
+							   m_vDrawableBindings.end() );
+}
+
+bool Scene::InitInstancing( std::string strVertSrc, std::string strFragSrc )
+{
+	if ( m_pWindow == nullptr )
+	{
+		std::cout << "Error: instancing needs a display" << std::endl;
+		return false;
+	}
+
+	// The ring only needs buffer objects. Before GL 4.4 it stages
+	// and orphans instead of staying mapped, but works the same.
+	// Room for a thousand or so instances to start, it grows if needed
+	m_bCanInstance = false;
+	if ( m_InstanceRing.GetBuffer() == 0 && m_InstanceRing.Init( 1024 * sizeof( InstanceData ) ) == false )
+		return false;
+
+	// Attribute divisors are core in 3.3, older contexts may have the extension
+	if ( !GLEW_VERSION_3_3 && !GLEW_ARB_instanced_arrays )
+	{
+		std::cout << "Instanced drawing needs GL 3.3 or ARB_instanced_arrays, drawing one at a time" << std::endl;
+		return false;
+	}
+
+	// Meshes were set up with the regular shader's position
+	// handle, so the instanced shader has to use it too
+	m_InstShader.BindAttribLocation( "a_Pos", Drawable::GetPosHandle() );
+	if ( m_InstShader.Init( strVertSrc, strFragSrc, true ) == false )
+		return false;
+
+	for ( Shader::EHandle eHandle : { Shader::EHandle::CamMat, Shader::EHandle::MV, Shader::EHandle::InstColor } )
+	{
+		if ( m_InstShader.GetHandle( eHandle ) < 0 )
+		{
+			std::cout << "Error: instanced shader is missing a variable" << std::endl;
+			return false;
+		}
+	}
+
+	m_bCanInstance = true;
+	return true;
+}
+
+void Scene::SetInstancedDraw( bool bInstanced )
+{
+	m_bInstancedDraw = bInstanced;
+}
+
+bool Scene::GetInstancedDraw() const
+{
+	return m_bInstancedDraw;
+}
+
+int Scene::GetNumDrawCalls() const
+{
+	return m_nDrawCalls;
+}
+
+bool Scene::GetPersistentMapping() const
+{
+	return m_InstanceRing.GetIsPersistent();
+}
+
+int Scene::GetNumStalledFrames() const
+{
+	return m_InstanceRing.GetNumStalls();
+}
+
+int Scene::GetNumIslands() const
+{
+	return (int) m_IslandGraph.GetNumIslands();
+}
+
+void Scene::SetBatchNarrowphase( bool bBatch )
+{
+	m_bBatchNarrowphase = bBatch;
+}
+
+bool Scene::GetBatchNarrowphase() const
+{
+	return m_bBatchNarrowphase;
+}
+
+void Scene::SetSIMDIntegrate( bool bSIMD )
+{
+	m_bSIMDIntegrate = bSIMD;
+}
+
+bool Scene::GetSIMDIntegrate() const
+{
+	return m_bSIMDIntegrate;
+}
+
+void Scene::SetBucketNarrowphase( bool bBucket )
+{
+	m_bBucketNarrowphase = bBucket;
+}
+
+bool Scene::GetBucketNarrowphase() const
+{
+	return m_bBucketNarrowphase;
+}
+
+// 1 is serial, 0 uses every hardware thread
+void Scene::SetThreadCount( int nThreads )
+{
+	m_JobPool.SetThreadCount( (uint32_t) std::max( 0, nThreads ) );
+}
+
+int Scene::GetThreadCount() const
+{
+	return (int) m_JobPool.GetThreadCount();
+}
+
+void Scene::SetSolverMode( ESolver eSolver )
+{
+	m_eSolver = eSolver;
+}
+
+Scene::ESolver Scene::GetSolverMode() const
+{
+	return m_eSolver;
+}
+
+// Only islands that had contacts, in order of their lowest body
+std::vector<int> Scene::GetIslandIterations() const
+{
+	const std::vector<uint32_t>& vIterations = m_ContactSolver.GetIslandIterations();
+	return std::vector<int>( vIterations.begin(), vIterations.end() );
+}
+
+void Scene::SetPlaneMargin( float fMargin )
+{
+	m_fPlaneMargin = fMargin;
+}
+
+float Scene::GetPlaneMargin() const
+{
+	return m_fPlaneMargin;
+}
+
+int Scene::GetNumPlaneContacts() const
+{
+	return m_nPlaneContacts;
+}
+
+void Scene::SetCullContacts( bool bCull )
+{
+	m_bCullContacts = bCull;
+}
+
+bool Scene::GetCullContacts() const
+{
+	return m_bCullContacts;
+}
+
+void Scene::SetCullMargin( float fMargin )
+{
+	m_fCullMargin = fMargin;
+}
+
+float Scene::GetCullMargin() const
+{
+	return m_fCullMargin;
+}
+
+int Scene::GetNumCulledContacts() const
+{
+	return m_nCulled;
+}
+
+int Scene::GetNumBroadphasePairs() const
+{
+	if ( m_eBroadphase == EBroadphase::UniformGrid )
+		return (int) m_SpatialHash.GetPairs().size();
+	return (int) m_SortAndSweep.GetPairs().size();
+}
+
+int Scene::GetSoftTreeHeight() const
+{
+	return m_SoftBodyTree.GetHeight();
+}
+
+int Scene::GetSoftTreeNodeCount() const
+{
+	return m_SoftBodyTree.GetNodeCount();
+}
+
+int Scene::GetNumBodyPairs() const
+{
+	// What the broadphase saved us from
+	size_t nActive = std::count_if( m_vRigidBodies.begin(), m_vRigidBodies.end(), [] ( const RigidBody2D& rb ) { return rb.GetIsActive(); } );
+	return nActive > 1 ? (int) (nActive * (nActive - 1) / 2) : 0;
+}
+
 bool Scene::InitDisplay( std::string strWindowName, vec4 v4ClearColor, std::map<std::string, int> mapDisplayAttrs )
 {
+	if ( m_bHeadless )
+	{
+		std::cout << "Error: headless scenes don't have a display" << std::endl;
+		return false;
+	}
+
 	SDL_Window * pWindow = nullptr;
 	SDL_GLContext glContext = nullptr;
 
@@ -2,13 +2,20 @@
 
 #include <fstream>
 #include <iostream>
+#include <cstring>
+
+// Names of the EHandle variables, in order
+static const char * s_aHandleNames[] = { "u_PMV", "u_Color", "u_CamMat", "a_Pos", "a_MV", "a_Color" };
+static_assert( sizeof( s_aHandleNames ) / sizeof( s_aHandleNames[0] ) == (size_t) Shader::EHandle::Count, "Every EHandle needs a name" );
 
 Shader::Shader() :
 	m_bIsBound( false ),
 	m_Program( 0 ),
 	m_hVertShader( 0 ),
 	m_hFragShader( 0 )
-{}
+{
+	m_aHandles.fill( -1 );
+}
 
 bool Shader::Init( std::string strVertSrc, std::string strFragSrc, bool fromDisk )
 {
@@ -71,6 +78,8 @@ bool Shader::Init( std::string strVertSrc, std::string strFragSrc, bool fromDisk
 	m_Program = glCreateProgram();
 	glAttachShader( m_Program, m_hVertShader );
 	glAttachShader( m_Program, m_hFragShader );
+	for ( auto& itAttrib : m_mapAttribLocations )
+		glBindAttribLocation( m_Program, itAttrib.second, itAttrib.first.c_str() );
 	glLinkProgram( m_Program );
 	if ( !check( m_Program, GL_LINK_STATUS ) )
 	{
@@ -92,23 +101,39 @@ bool Shader::Init( std::string strVertSrc, std::string strFragSrc, bool fromDisk
 	glGetProgramiv( m_Program, GL_ACTIVE_UNIFORMS, &nUniforms );
 	glGetProgramiv( m_Program, GL_ACTIVE_ATTRIBUTES, &nAttributes );
 
+	// Put the ones we know about in the table as well
+	m_aHandles.fill( -1 );
+	auto fillTable = [this] ( const char * szName, GLint iLocation )
+	{
+		for ( size_t h = 0; h < m_aHandles.size(); h++ )
+			if ( strcmp( szName, s_aHandleNames[h] ) == 0 )
+				m_aHandles[h] = iLocation;
+	};
+
 	for ( int i = 0; i < nUniforms; i++ )
 	{
 		memset( szNameBuf, 0, sizeof( szNameBuf ) );
 		glGetActiveUniform( m_Program, i, uMaxNumChars, &uLen, &iSize, &eType, szNameBuf );
-		m_mapHandles[szNameBuf] = i;
+		m_mapHandles[szNameBuf] = glGetUniformLocation( m_Program, szNameBuf );
+		fillTable( szNameBuf, m_mapHandles[szNameBuf] );
 	}
 
 	for ( int i = 0; i < nAttributes; i++ )
 	{
 		memset( szNameBuf, 0, sizeof( szNameBuf ) );
 		glGetActiveAttrib( m_Program, i, uMaxNumChars, &uLen, &iSize, &eType, szNameBuf );
-		m_mapHandles[szNameBuf] = i;
+		m_mapHandles[szNameBuf] = glGetAttribLocation( m_Program, szNameBuf );
+		fillTable( szNameBuf, m_mapHandles[szNameBuf] );
 	}
 
 	return true;
 }
 
+void Shader::BindAttribLocation( const std::string strVarName, GLint iLocation )
+{
+	m_mapAttribLocations[strVarName] = iLocation;
+}
+
 // Managing bound state
 bool Shader::Bind()
 {
@@ -147,6 +172,20 @@ GLint Shader::GetHandle( const std::string strVarName )
 	return -1;
 }
 
+GLint Shader::GetHandle( EHandle eHandle ) const
+{
+	return m_aHandles[(size_t) eHandle];
+}
+
+GLint Shader::GetHandleByID( int ixHandle ) const
+{
+	if ( ixHandle >= 0 && ixHandle < (int) EHandle::Count )
+		return m_aHandles[ixHandle];
+
+	std::cerr << "Error! Invalid shader handle ID " << ixHandle << " queried!" << std::endl;
+	return -1;
+}
+
 // Print Logs
 int Shader::PrintLog_V() const
 {
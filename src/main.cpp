@@ -6,17 +6,35 @@
 #include <SDL.h>
 #include <pyliaison.h>
 
+#include <string>
+
 int main(int argc, char ** argv)
 {
+	// --headless runs physics only, without a window or GL context,
+	// and --script picks the script (headless ones don't need SDL)
+	bool bHeadless = false;
+	std::string strScript;
+	for ( int i = 1; i < argc; i++ )
+	{
+		std::string strArg = argv[i];
+		if ( strArg == "--headless" )
+			bHeadless = true;
+		else if ( strArg == "--script" && i + 1 < argc )
+			strScript = argv[++i];
+	}
+	if ( strScript.empty() )
+		strScript = bHeadless ? "../scripts/headless.py" : "../scripts/main.py";
+
 	// Expose all python modules and initialize interpreter
 	ExposeAll();
 	pyl::initialize();
 
 	// Get main python script object
-	pyl::Object obMainScript = pyl::Object::from_script( "../scripts/main.py" );
+	pyl::Object obMainScript = pyl::Object::from_script( strScript );
 
 	// Declare scene, initialize from python
 	Scene S;
+	S.SetHeadless( bHeadless );
 	obMainScript.call( "Initialize", &S );
 
 	// Main loop
@@ -25,7 +43,7 @@ int main(int argc, char ** argv)
 	{
 		// Handle events in python
 		SDL_Event e{ 0 };
-		while ( SDL_PollEvent( &e ) )
+		while ( bHeadless == false && SDL_PollEvent( &e ) )
 		{
 			obMainScript.call( "HandleEvent", &e, &S );
 		} 
@@ -38,4 +56,4 @@ int main(int argc, char ** argv)
 	// Tear down interpreter and get out
 	pyl::finalize();
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+// GetSpecContact( AABB *, AABB * ) as it was before it went branch free,
+// kept verbatim so the tests and the benchmark can compare against it.
+// It always takes +x / +y as the normal when the boxes overlap on both
+// axes, whichever side A is on, which the branch free version fixed.
+// Everywhere else they should agree to within rounding
+
+#include "RigidBody2D.h"
+#include "CollisionFunctions.h"
+#include "Contact.h"
+
+#include <algorithm>
+
+// This is rather verbose, but it gets the job done
+inline Contact GetSpecContactIfElse( AABB * pA, AABB * pB )
+{
+	// Contact normal and indices from each box
+	vec2 n;
+	int vIdxA, vIdxB;
+
+	// Get the overlap directions
+	bool bX = IsOverlappingX( pA, pB );
+	bool bY = IsOverlappingY( pA, pB );
+
+	// If we have a genuine overlap, then I haven't done my job...
+	if ( bX && bY )
+	{
+		// Find the direction of least penetration (X or Y),
+		// take A's face in that direction to be the collision normal
+		float fPenX( 0 ), fPenY( 0 );
+		int vIdxAX( 0 ), vIdxAY( 0 ), vIdxBX( 0 ), vIdxBY( 0 );
+		vec2 v2NrmX, v2NrmY;
+
+		// Determine which direction the overlap occurs in X
+		if ( pA->Right() > pB->Left() && pA->Left() < pB->Right() )
+		{
+			// A is overlapping B from the left
+			fPenX = std::min( 0.f, pB->Left() - pA->Right() );
+			v2NrmX = vec2( 1, 0 );
+			vIdxAX = 0;
+			vIdxBX = 2;
+		}
+		else
+		{
+			// A is overlapping B from the right
+			fPenX = std::min( 0.f, pA->Left() - pB->Right() );
+			v2NrmX = vec2( -1, 0 );
+			vIdxAX = 2;
+			vIdxBX = 0;
+		}
+
+		// Determine which direction the overlap occurs in X
+		if ( pA->Top() > pB->Bottom() && pA->Bottom() < pB->Top() )
+		{
+			// A is overlapping B from below
+			fPenY = std::min( 0.f, pB->Bottom() - pA->Top() );
+			v2NrmY = vec2( 0, 1 );
+			vIdxAY = 3;
+			vIdxBY = 1;
+		}
+		else
+		{
+			// A is overlapping B from above
+			fPenY = std::min( 0.f, pA->Bottom() - pB->Top() );
+			v2NrmY = vec2( 0, -1 );
+			vIdxAY = 1;
+			vIdxBY = 3;
+		}
+
+		// Pick the least penetration distance
+		// The penetration distances are <= 0,
+		// and we want the one closest to 0
+		if ( fPenX > fPenY )
+		{
+			// X penetrates less than Y
+			n = v2NrmX;
+			vIdxA = vIdxAX;
+			vIdxB = vIdxBX;
+		}
+		else
+		{
+			// the other way around
+			n = v2NrmY;
+			vIdxA = vIdxAY;
+			vIdxB = vIdxBY;
+		}
+	}
+	// We're overlapping X, worry about vertical collisions
+	else if ( bX )
+	{
+		// If We're below
+		if ( pA->Top() <= pB->Bottom() )
+		{
+			// top of A, bottpm of B
+			n = vec2( 0, 1 );
+			vIdxA = 3;
+			vIdxB = 1;
+		}
+		else
+		{
+			// bottom of A, top of B
+			n = vec2( 0, -1 );
+			vIdxA = 1;
+			vIdxB = 3;
+		}
+	}
+	// We're overlapping Y, worry about horizontal collisions
+	else if ( bY )
+	{
+		if ( pA->Right() < pB->Left() )
+		{
+			// right of A, left of B
+			n = vec2( 1, 0 );
+			vIdxA = 0;
+			vIdxB = 2;
+		}
+		else
+		{
+			// left of A, right of B
+			n = vec2( -1, 0 );
+			vIdxA = 2;
+			vIdxB = 0;
+		}
+	}
+	else
+	{
+		// If we aren't overlapping in either direction
+		// handle a potential corner collision
+		bool bAIsLeft = (pA->Right() < pB->Left());
+		bool bAIsBelow = (pA->Top() < pB->Bottom());
+		if ( bAIsLeft )
+		{
+			if ( bAIsBelow )
+			{
+				// Top right of A, bottom left of B
+				vIdxA = 0;
+				vIdxB = 2;
+			}
+			else
+			{
+				// Bottom right of A, top left of B
+				vIdxA = 1;
+				vIdxB = 3;
+			}
+		}
+		else
+		{
+			if ( bAIsBelow )
+			{
+				// Top left of A, bottom right of B
+				vIdxA = 3;
+				vIdxB = 1;
+			}
+			else
+			{
+				// Bottom left of A, top right of B
+				vIdxA = 2;
+				vIdxB = 0;
+			}
+		}
+
+		// We don't need to average contact positions for the corner case
+		vec2 posA = GetVert( pA, vIdxA );
+		vec2 posB = GetVert( pB, vIdxB );
+		n = glm::normalize( posB - posA );
+		float fDist = glm::distance( posA, posB );
+		return Contact( (RigidBody2D *) pA, (RigidBody2D *) pB, posA, posB, n, fDist );
+	}
+
+	// For the face case, we get the two vertices from each colliding face
+	// and average them per face, so that the collision is not diminished
+	// by the radius arm of the contact. Distance is along direction of normal
+	vec2 posA = 0.5f * (GetVert( pA, vIdxA ) + GetVert( pA, vIdxA + 1 ));
+	vec2 posB = 0.5f * (GetVert( pB, vIdxB ) + GetVert( pB, vIdxB + 1 ));
+	float fDist = glm::dot( n, posB - posA );
+	return Contact( (RigidBody2D *) pA, (RigidBody2D *) pB, posA, posB, n, fDist );
+}
@@ -0,0 +1,105 @@
+// Times the batched narrowphase kernels against calling
+// GetSpeculativeContact once per pair, for circles and boxes.
+// Boxes also get timed with the old if / else GetSpecContact,
+// which is what the branch free version and the kernel replaced.
+// Not a test, run it by hand with an optional pair count
+
+#include "ContactKernels.h"
+#include "RigidBodyStore.h"
+#include "RigidBody2D.h"
+#include "CollisionFunctions.h"
+#include "Contact.h"
+#include "BoxContactReference.h"
+
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include <iostream>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static const int kNumRuns = 20;
+
+// Best of kNumRuns, in nanoseconds per pair
+template <typename F>
+static double timePairs( size_t nPairs, F fn )
+{
+	double dBest = 1e30;
+	for ( int i = 0; i < kNumRuns; i++ )
+	{
+		Clock::time_point tStart = Clock::now();
+		fn();
+		double dNS = std::chrono::duration<double, std::nano>( Clock::now() - tStart ).count();
+		dBest = std::min( dBest, dNS );
+	}
+	return dBest / (double) std::max<size_t>( nPairs, 1 );
+}
+
+static Contact ifElseBoxContact( const RigidBody2D * pA, const RigidBody2D * pB )
+{
+	return GetSpecContactIfElse( (AABB *) pA, (AABB *) pB );
+}
+
+// fnOld is an older per pair function to time as well, if there is one
+static void bench( const char * szName, std::vector<RigidBody2D>& vBodies, size_t nPairs, std::mt19937& rng,
+				   void( *fnKernel )(const RigidBodyStore&, RigidBody2D *, Span<const BodyPair>, Contact *),
+				   SpecContactFn fnOld )
+{
+	RigidBodyStore store;
+	store.Integrate( vBodies, 0.f );
+
+	std::uniform_int_distribution<uint32_t> dIdx( 0, (uint32_t) vBodies.size() - 1 );
+	std::vector<BodyPair> vPairs;
+	while ( vPairs.size() < nPairs )
+	{
+		uint32_t a = dIdx( rng ), b = dIdx( rng );
+		if ( a != b )
+			vPairs.emplace_back( std::min( a, b ), std::max( a, b ) );
+	}
+	std::vector<Contact> vContacts( vPairs.size() );
+
+	double dKernel = timePairs( nPairs, [&] () {
+		fnKernel( store, vBodies.data(), vPairs, vContacts.data() );
+	} );
+
+	// Every pair is the same type, so look the function up once like the Scene does
+	SpecContactFn fnSpec = GetSpecContactFn( &vBodies[0], &vBodies[0] );
+	double dScalar = timePairs( nPairs, [&] () {
+		for ( size_t i = 0; i < vPairs.size(); i++ )
+			vContacts[i] = fnSpec( &vBodies[vPairs[i].first], &vBodies[vPairs[i].second] );
+	} );
+
+	std::cout << szName << ": kernel " << dKernel << " ns/pair, GetSpecContact " << dScalar << " ns/pair";
+	if ( fnOld )
+	{
+		double dOld = timePairs( nPairs, [&] () {
+			for ( size_t i = 0; i < vPairs.size(); i++ )
+				vContacts[i] = fnOld( &vBodies[vPairs[i].first], &vBodies[vPairs[i].second] );
+		} );
+		std::cout << ", old " << dOld << " ns/pair";
+	}
+	std::cout << std::endl;
+}
+
+int main( int argc, char ** argv )
+{
+	size_t nPairs = argc > 1 ? (size_t) std::atoi( argv[1] ) : 100000;
+	std::mt19937 rng( 1 );
+	// Packed closely enough that there's a mix of corner, face and
+	// overlapping pairs, so the old version's branches don't all go one way
+	std::uniform_real_distribution<float> dPos( -10.f, 10.f );
+	std::uniform_real_distribution<float> dSize( 0.1f, 4.f );
+
+	std::vector<RigidBody2D> vCircles, vBoxes;
+	for ( int i = 0; i < 4096; i++ )
+	{
+		vCircles.push_back( Circle::Create( vec2( 0 ), vec2( dPos( rng ), dPos( rng ) ), 1.f, 1.f, dSize( rng ) ) );
+		vBoxes.push_back( AABB::Create( vec2( 0 ), vec2( dPos( rng ), dPos( rng ) ), 1.f, 1.f, vec2( dSize( rng ), dSize( rng ) ) ) );
+	}
+
+	bench( "Circles", vCircles, nPairs, rng, GetCircleContacts, nullptr );
+	bench( "Boxes", vBoxes, nPairs, rng, GetBoxContacts, ifElseBoxContact );
+
+	return 0;
+}
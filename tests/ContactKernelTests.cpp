@@ -0,0 +1,204 @@
+// Checks the batched narrowphase kernels against the per pair
+// GetSpecContact functions. Built once per SIMD path (scalar, SSE,
+// AVX), so every path gets compared to the same reference
+
+#include "ContactKernels.h"
+#include "RigidBodyStore.h"
+#include "RigidBody2D.h"
+#include "CollisionFunctions.h"
+#include "Contact.h"
+#include "BoxContactReference.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <random>
+#include <iostream>
+
+static int s_nFailures = 0;
+
+static void check( bool bOK, const char * szWhat, size_t ixPair )
+{
+	if ( bOK == false && s_nFailures++ < 10 )
+		std::cout << "FAIL: " << szWhat << " (pair " << ixPair << ")" << std::endl;
+}
+
+// Compares bits, so -0 and 0 are different
+static bool sameBits( float a, float b )
+{
+	return std::memcmp( &a, &b, sizeof( float ) ) == 0;
+}
+
+static bool near( float a, float b, float fTol )
+{
+	return std::fabs( a - b ) <= fTol * std::max( 1.f, std::fabs( b ) );
+}
+
+// Random pairs of different bodies, lower index first
+static std::vector<BodyPair> makePairs( std::mt19937& rng, size_t nBodies, size_t nPairs )
+{
+	std::uniform_int_distribution<uint32_t> dIdx( 0, (uint32_t) nBodies - 1 );
+	std::vector<BodyPair> vPairs;
+	while ( vPairs.size() < nPairs )
+	{
+		uint32_t a = dIdx( rng ), b = dIdx( rng );
+		if ( a != b )
+			vPairs.emplace_back( std::min( a, b ), std::max( a, b ) );
+	}
+	return vPairs;
+}
+
+// The kernel's circle lane math, done one pair at a time. Every SIMD
+// path uses IEEE sqrt and div, so they should all match this exactly
+static void circleReference( const RigidBody2D& A, const RigidBody2D& B, vec2& n, float& fDist )
+{
+	float dX = B.v2Center.x - A.v2Center.x;
+	float dY = B.v2Center.y - A.v2Center.y;
+	float fLen = std::sqrt( dX * dX + dY * dY );
+	float fInvLen = 1.f / fLen;
+	n = vec2( dX * fInvLen, dY * fInvLen );
+	fDist = fLen - A.fRadius - B.fRadius;
+}
+
+static void testCircles( std::mt19937& rng, size_t nPairs )
+{
+	std::uniform_real_distribution<float> dPos( -20.f, 20.f );
+	std::uniform_real_distribution<float> dRad( 0.1f, 4.f );
+
+	std::vector<RigidBody2D> vBodies;
+	for ( int i = 0; i < 64; i++ )
+		vBodies.push_back( Circle::Create( vec2( 0 ), vec2( dPos( rng ), dPos( rng ) ), 1.f, 1.f, dRad( rng ) ) );
+
+	// A dt of 0 just fills the store
+	RigidBodyStore store;
+	store.Integrate( vBodies, 0.f );
+
+	std::vector<BodyPair> vPairs = makePairs( rng, vBodies.size(), nPairs );
+	std::vector<Contact> vContacts( vPairs.size() );
+	GetCircleContacts( store, vBodies.data(), vPairs, vContacts.data() );
+
+	for ( size_t i = 0; i < vPairs.size(); i++ )
+	{
+		RigidBody2D * pA = &vBodies[vPairs[i].first];
+		RigidBody2D * pB = &vBodies[vPairs[i].second];
+		const Contact& c = vContacts[i];
+
+		check( c.GetBodyA() == pA && c.GetBodyB() == pB, "circle bodies", i );
+
+		vec2 n;
+		float fDist;
+		circleReference( *pA, *pB, n, fDist );
+		check( sameBits( c.GetNormal().x, n.x ) && sameBits( c.GetNormal().y, n.y ), "circle normal bits", i );
+		check( sameBits( c.GetDistance(), fDist ), "circle distance bits", i );
+
+		// GetSpecContact normalizes and measures between contact
+		// points, so it's only the same to within a few ULPs
+		Contact cRef = GetSpeculativeContact( pA, pB );
+		check( near( c.GetNormal().x, cRef.GetNormal().x, 1e-5f ) && near( c.GetNormal().y, cRef.GetNormal().y, 1e-5f ), "circle normal", i );
+		check( near( c.GetDistance(), cRef.GetDistance(), 1e-4f ), "circle distance", i );
+	}
+}
+
+static void testBoxes( std::mt19937& rng, size_t nPairs )
+{
+	std::uniform_real_distribution<float> dPos( -20.f, 20.f );
+	std::uniform_real_distribution<float> dHalf( 0.1f, 4.f );
+
+	// Snapping some centers to a grid gets exact ties
+	// between the axes, and zero offsets along one
+	std::vector<RigidBody2D> vBodies;
+	for ( int i = 0; i < 64; i++ )
+	{
+		vec2 v2Pos( dPos( rng ), dPos( rng ) );
+		vec2 v2Half( dHalf( rng ), dHalf( rng ) );
+		if ( i % 4 == 0 )
+		{
+			v2Pos = glm::floor( v2Pos );
+			v2Half = vec2( 1.f );
+		}
+		vBodies.push_back( AABB::Create( vec2( 0 ), v2Pos, 1.f, 1.f, v2Half ) );
+	}
+
+	RigidBodyStore store;
+	store.Integrate( vBodies, 0.f );
+
+	std::vector<BodyPair> vPairs = makePairs( rng, vBodies.size(), nPairs );
+	std::vector<Contact> vContacts( vPairs.size() );
+	GetBoxContacts( store, vBodies.data(), vPairs, vContacts.data() );
+
+	for ( size_t i = 0; i < vPairs.size(); i++ )
+	{
+		RigidBody2D * pA = &vBodies[vPairs[i].first];
+		RigidBody2D * pB = &vBodies[vPairs[i].second];
+		const Contact& c = vContacts[i];
+
+		// The kernel is meant to be bit for bit with the scalar function
+		Contact cRef = GetSpeculativeContact( pA, pB );
+		check( c.GetBodyA() == pA && c.GetBodyB() == pB, "box bodies", i );
+		check( sameBits( c.GetNormal().x, cRef.GetNormal().x ) && sameBits( c.GetNormal().y, cRef.GetNormal().y ), "box normal bits", i );
+		check( sameBits( c.GetDistance(), cRef.GetDistance() ), "box distance bits", i );
+		check( sameBits( c.GetAvgCoefRest(), cRef.GetAvgCoefRest() ), "box restitution bits", i );
+
+		// And both should behave like the old if / else version. The one
+		// exception is on purpose: when the boxes overlap on both axes the
+		// old one always pointed along +x / +y and measured from that side,
+		// even with A on the right of or above B. If they only touched on
+		// an axis it measured that axis from the far side instead. There
+		// the new contact is only checked against what it should be, the
+		// least penetrating axis pointing from A to B
+		AABB * pBoxA = (AABB *) pA;
+		AABB * pBoxB = (AABB *) pB;
+		vec2 d = pB->v2Center - pA->v2Center;
+		vec2 g = glm::abs( d ) - (pA->v2HalfDim + pB->v2HalfDim);
+		bool bDeep = IsOverlappingX( pBoxA, pBoxB ) && IsOverlappingY( pBoxA, pBoxB );
+		bool bStrict = pBoxA->Right() > pBoxB->Left() && pBoxA->Left() < pBoxB->Right() &&
+			pBoxA->Top() > pBoxB->Bottom() && pBoxA->Bottom() < pBoxB->Top();
+		if ( bDeep && (d.x < 0 || d.y < 0 || bStrict == false) )
+		{
+			bool bUseX = g.x > g.y;
+			vec2 nExpected = bUseX ? vec2( d.x < 0 ? -1 : 1, 0 ) : vec2( 0, d.y < 0 ? -1 : 1 );
+			check( c.GetNormal() == nExpected, "deep box normal", i );
+			check( sameBits( c.GetDistance(), bUseX ? g.x : g.y ), "deep box distance", i );
+			continue;
+		}
+
+		// Face normals are exact axes in both. The old corner normal is
+		// normalized from the corners' difference, which is badly off
+		// for tiny gaps, so corners compare normal * distance instead
+		Contact cOld = GetSpecContactIfElse( pBoxA, pBoxB );
+		if ( g.x > 0 && g.y > 0 )
+		{
+			vec2 v2Sep = c.GetNormal() * c.GetDistance();
+			vec2 v2OldSep = cOld.GetNormal() * cOld.GetDistance();
+			check( near( v2Sep.x, v2OldSep.x, 1e-5f ) && near( v2Sep.y, v2OldSep.y, 1e-5f ), "box corner vs if / else", i );
+		}
+		else
+			check( c.GetNormal() == cOld.GetNormal(), "box normal vs if / else", i );
+		check( near( c.GetDistance(), cOld.GetDistance(), 1e-5f ), "box distance vs if / else", i );
+	}
+}
+
+int main()
+{
+	std::mt19937 rng( 1 );
+
+	// Every count up to a few blocks, so the scalar
+	// leftovers get run after each number of full blocks
+	for ( size_t nPairs = 0; nPairs < 40; nPairs++ )
+	{
+		testCircles( rng, nPairs );
+		testBoxes( rng, nPairs );
+	}
+
+	testCircles( rng, 10000 );
+	testBoxes( rng, 10000 );
+
+	if ( s_nFailures )
+	{
+		std::cout << s_nFailures << " failures" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Contact kernels match" << std::endl;
+	return 0;
+}
@@ -0,0 +1,105 @@
+// Times RigidBodyStore::Integrate (one pass over the bodies, scalar
+// math) against IntegrateSIMD (gather into the SoA arrays, SSE / AVX
+// loop, scatter back), and checks they leave the bodies the same.
+// Not a test, run it by hand with an optional number of steps
+
+#include "RigidBodyStore.h"
+#include "RigidBody2D.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <cstdlib>
+#include <iostream>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static const float kDT = 0.005f;
+
+// A mix like a real scene: mostly awake and movable,
+// with some sleeping, inactive and immovable bodies
+static std::vector<RigidBody2D> makeBodies( std::mt19937& rng, size_t nBodies )
+{
+	std::uniform_real_distribution<float> dPos( -100.f, 100.f );
+	std::uniform_real_distribution<float> dVel( -5.f, 5.f );
+	std::uniform_real_distribution<float> dSize( 0.1f, 4.f );
+	std::uniform_int_distribution<int> dKind( 0, 15 );
+
+	std::vector<RigidBody2D> vBodies;
+	for ( size_t i = 0; i < nBodies; i++ )
+	{
+		vec2 v2Pos( dPos( rng ), dPos( rng ) );
+		vec2 v2Vel( dVel( rng ), dVel( rng ) );
+		int iKind = dKind( rng );
+		float fMass = iKind == 0 ? -1.f : 1.f + dSize( rng );
+		if ( i % 2 )
+			vBodies.push_back( Circle::Create( v2Vel, v2Pos, fMass, 1.f, dSize( rng ) ) );
+		else
+			vBodies.push_back( AABB::Create( v2Vel, v2Pos, fMass, 1.f, vec2( dSize( rng ), dSize( rng ) ) ) );
+
+		RigidBody2D& rb = vBodies.back();
+		rb.SetForce( vec2( dVel( rng ), dVel( rng ) - 9.8f ) );
+		rb.bAsleep = iKind == 1;
+		rb.SetIsActive( iKind != 2 );
+	}
+	return vBodies;
+}
+
+static bool sameBits( vec2 a, vec2 b )
+{
+	return std::memcmp( &a, &b, sizeof( vec2 ) ) == 0;
+}
+
+// Best of five runs of nSteps, in nanoseconds per body per step
+template <typename F>
+static double timeSteps( size_t nBodies, int nSteps, F fn )
+{
+	double dBest = 1e30;
+	for ( int r = 0; r < 5; r++ )
+	{
+		Clock::time_point tStart = Clock::now();
+		for ( int s = 0; s < nSteps; s++ )
+			fn();
+		double dNS = std::chrono::duration<double, std::nano>( Clock::now() - tStart ).count();
+		dBest = std::min( dBest, dNS );
+	}
+	return dBest / (double) (nBodies * nSteps);
+}
+
+int main( int argc, char ** argv )
+{
+	int nSteps = argc > 1 ? std::atoi( argv[1] ) : 100;
+	std::mt19937 rng( 1 );
+	bool bAllMatch = true;
+
+	std::cout << "bodies\tone pass\tgather + SIMD + scatter\t(ns per body per step)" << std::endl;
+	for ( size_t nBodies : { 64, 1024, 16384, 262144 } )
+	{
+		std::vector<RigidBody2D> vOnePass = makeBodies( rng, nBodies );
+		std::vector<RigidBody2D> vSIMD = vOnePass;
+		RigidBodyStore storeOnePass, storeSIMD;
+
+		// One step each from the same start has to come out the same,
+		// bodies and arrays. After that forces are zero, which doesn't
+		// change the amount of work
+		storeOnePass.Integrate( vOnePass, kDT );
+		storeSIMD.IntegrateSIMD( vSIMD, kDT );
+		bool bMatch = true;
+		for ( size_t i = 0; i < nBodies; i++ )
+		{
+			bMatch = bMatch && sameBits( vOnePass[i].v2Center, vSIMD[i].v2Center );
+			bMatch = bMatch && sameBits( vOnePass[i].v2Vel, vSIMD[i].v2Vel );
+			bMatch = bMatch && sameBits( vOnePass[i].v2Force, vSIMD[i].v2Force );
+			bMatch = bMatch && storeOnePass.PosX()[i] == storeSIMD.PosX()[i] && storeOnePass.PosY()[i] == storeSIMD.PosY()[i];
+			bMatch = bMatch && storeOnePass.Active()[i] == storeSIMD.Active()[i];
+		}
+		bAllMatch = bAllMatch && bMatch;
+
+		double dOnePass = timeSteps( nBodies, nSteps, [&] () { storeOnePass.Integrate( vOnePass, kDT ); } );
+		double dSIMD = timeSteps( nBodies, nSteps, [&] () { storeSIMD.IntegrateSIMD( vSIMD, kDT ); } );
+		std::cout << nBodies << "\t" << dOnePass << "\t" << dSIMD << (bMatch ? "" : "\tMISMATCH") << std::endl;
+	}
+
+	return bAllMatch ? 0 : 1;
+}